@@ -1,15 +1,145 @@
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <omp.h>
 #include <time.h>
 #include <stdbool.h>
+#include <unistd.h>
+#include <limits.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
 #define GRID_SIZE 100
 #define ITERATIONS 100
 #define CENTER_SIZE 10
 #define MEASUREMENTS 5
 
+// Cells are stored as numeric 0/1 bytes so neighbour counts are plain sums; '*' and '.' only appear when printing
+#define CELL_DEAD 0
+#define CELL_LIVE 1
+
+#define WORKLOAD_SEED 12345
+#define DEFAULT_TILE_SIZE 64
+#define TUNE_PROFILE_FILE ".game_of_life_tuning"
+#define TUNE_PROBE_SECONDS 0.05   // Target wall time of a single tuning probe
+#define TUNE_REPETITIONS 2        // Each probe keeps the best of this many runs
+#define CROSSOVER_GRID 256         // Grid side used to measure the per-cell cost
+#define CROSSOVER_SYNC_ROUNDS 2000 // Worksharing loops timed to measure the per-generation sync cost
+#define CROSSOVER_MARGIN 4         // A thread's share of work must outweigh the sync cost this many times
+#define GRID_HEADER 64             // Bytes in front of each grid holding its size, keeps cells cache-line aligned
+#define HUGE_PAGE_SIZE (2u << 20)  // Grids of at least this many bytes are mapped on 2 MB pages
+#define GRID_POOL_SLOTS 16         // Released grid buffers kept for reuse
+#define DEFAULT_PREFETCH_ROWS 2    // Rows ahead prefetched by the streaming kernel
+#define BARRIER_SPINS 4000         // Polls of a barrier before a waiting thread sleeps on the futex
+#define BARRIER_ROUNDS 20000       // Barrier episodes timed by --compare-backends
+#define MEMO_TILE 8                // Side of the tiles cached by the memo engine
+#define DEFAULT_MEMO_BITS 16       // log2 of the entries in each thread's memo table
+#define MAX_RULE_STATES 16         // Generations rules store cells in up to four bit planes
+#define PUBLISH_MAGIC 0x4546494cu  // "LIFE" marks a completely initialized shared grid segment
+#define PUBLISH_HEADER 128         // Bytes in front of the two published grid slots
+#define ATTACH_WAIT_SECONDS 10     // How long --attach waits for a publisher to create the segment
+#define SERVICE_LINE 512           // Longest request line accepted by --serve
+#define SERVICE_MAX_CELLS (1LL << 28) // Largest grid a service job may request (256 MB per buffer)
+#define SERVICE_SEND_TIMEOUT 5     // Seconds a service client may stall a send before it is dropped
+#define SERVICE_SLICE 0.005        // Target wall time of one scheduling slice of a service world
+#define SERVICE_SLACK 0.02         // Least slack (seconds) before a world's deadline overrides the fair share
+#define FALLBACK_LLC_BYTES (32u << 20) // Last-level cache size assumed when the system does not report one
+
+// Runtime configuration of a workload engine
+typedef struct {
+    int threads;
+    omp_sched_t schedule;
+    int chunk;   // 0 selects the OpenMP default chunk size
+    int tile;
+    int prefetch;  // Input rows prefetched ahead by streaming kernels (0: none)
+    // Called by observing engines with the row-major grid after every generation (NULL: none)
+    void (*on_generation)(const char *grid, long long generation);
+} EngineConfig;
+
+// Engines advance a runtime-sized toroidal grid by a number of generations in place
+typedef void (*engine_func)(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+
+typedef struct {
+    const char *name;
+    engine_func run;
+    bool parallel;   // Honors config->threads
+    bool scheduled;  // Honors config->schedule and config->chunk
+    bool tiled;      // Honors config->tile
+    bool blocks;     // Distributes tile x tile blocks instead of rows or row bands
+    bool streams;    // Streams output past the cache on large grids and honors config->prefetch
+    bool bounded;    // Supports every boundary condition, not only the torus
+    bool multistate; // Supports Generations rules with more than two states
+    bool ranged;     // Runs Larger-than-Life rules (and only those)
+    bool observed;   // Calls config->on_generation inside its generation loop
+} Engine;
+
+// Boundary conditions fill the one-cell halo of a (rows + 2) x (cols + 2) padded grid
+typedef void (*halo_fill)(char *padded, int rows, int cols);
+
+typedef struct {
+    const char *name;
+    halo_fill fill;
+} Boundary;
+
+// Life-like rule in B/S notation: bit n of birth (survive) is set when a dead (live) cell
+// with n live neighbours is alive in the next generation. Generations rules (B/S/C notation)
+// add dying states: a live cell that does not survive, and every dying cell, advances one state
+// per generation until it wraps to dead; only live (state 1) cells count as neighbours.
+typedef struct {
+    uint16_t birth;
+    uint16_t survive;
+    uint8_t states;   // 2 for Life-like rules, up to MAX_RULE_STATES for Generations rules
+} Rule;
+
+// Larger-than-Life rule such as R5,C0,M1,S34..58,B34..45: a cell counts the live cells of the
+// (2R+1) x (2R+1) box around it, itself included when M1, and is alive in the next generation
+// when a live cell's count lies in the S range or a dead cell's count in the B range
+typedef struct {
+    int radius;       // 0 when no Larger-than-Life rule is active
+    bool middle;
+    int survive_min, survive_max;
+    int birth_min, birth_max;
+} LtlRule;
+
+// Bitwise network evaluating a rule on the neighbour-count bit planes of 64 cells at once.
+// Counts 0-7 are decoded from the two low planes and selected by plane 2; count 8 is plane 3 alone.
+typedef enum {
+    RULE_NETWORK_GENERIC,
+    RULE_NETWORK_CONWAY,    // B3/S23
+    RULE_NETWORK_HIGHLIFE   // B36/S23
+} RuleNetworkKind;
+
+typedef struct {
+    RuleNetworkKind kind;
+    uint8_t birth_low, birth_high, survive_low, survive_high;  // Counts 0-3 and 4-7, one bit each
+    bool birth_eight, survive_eight;
+} RuleNetwork;
+
+// Grid size, initial density and length of a runtime workload
+typedef struct {
+    int rows;
+    int cols;
+    float density;   // <= 0 selects the centered CENTER_SIZE block
+    int generations;
+} Workload;
+
 // Function prototypes
 void initialize_grid(char grid[GRID_SIZE][GRID_SIZE]);
 int count_neighbors(char grid[GRID_SIZE][GRID_SIZE], int row, int col);
@@ -20,8 +150,522 @@ void simulate_parallel_static_no_critical(char grid[GRID_SIZE][GRID_SIZE], char
 void simulate_parallel_guided_no_critical(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE]);
 void print_grid(char grid[GRID_SIZE][GRID_SIZE]);
 double run_simulation(void (*simulate_func)(char[GRID_SIZE][GRID_SIZE], char[GRID_SIZE][GRID_SIZE]), const char* label, bool print_final);
+void print_usage();
+char *alloc_grid(int rows, int cols);
+char *try_alloc_grid(int rows, int cols);
+void free_grid(char *grid);
+void drain_grid_pool();
+void print_grid_pool_report();
+void initialize_workload_grid(char *grid, const Workload *workload);
+int count_live(const char *grid, int rows, int cols);
+void print_workload_grid(const char *grid, int rows, int cols);
+void engine_serial(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_parallel_rows(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_parallel_tiled(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_parallel_collapse(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_parallel_blocked(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_inplace(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_running_sum(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_swar(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+size_t last_level_cache_bytes();
+bool grid_streams(int rows, int cols);
+void engine_block_table(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_bitpack(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_morton(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_pthreads(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_stealing(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_memo(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_pow2(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_halo(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_generations(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_generations_reference(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_ltl(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+void engine_ltl_reference(char *grid, int rows, int cols, int generations, const EngineConfig *config);
+bool parse_ltl_rule(const char *text, LtlRule *rule);
+void format_active_rule(char *text, size_t len);
+bool engine_supports_workload(const Engine *engine);
+void fill_halo_torus(char *padded, int rows, int cols);
+void fill_halo_dead(char *padded, int rows, int cols);
+void fill_halo_reflect(char *padded, int rows, int cols);
+void fill_halo_klein(char *padded, int rows, int cols);
+const Boundary *find_boundary(const char *name);
+const Engine *reference_engine();
+int compare_backends(const Workload *workload, const EngineConfig *overrides);
+int sweep_layouts(const Workload *workload, const EngineConfig *overrides);
+bool perf_counters_begin();
+void perf_counters_end(long long counts[]);
+void build_block_table(const Rule *rule);
+bool parse_rule(const char *text, Rule *rule);
+void format_rule(const Rule *rule, char *text, size_t len);
+int engine_work_items(const Engine *engine, int rows, int cols, const EngineConfig *config);
+int sweep_aspect_ratios(const Workload *workload, const EngineConfig *overrides);
+const Engine *find_engine(const char *name);
+const char *schedule_name(omp_sched_t schedule);
+bool parse_schedule(const char *name, omp_sched_t *schedule);
+void default_engine_config(EngineConfig *config);
+double time_engine(const Engine *engine, const char *initial, char *work, int rows, int cols,
+                   int generations, const EngineConfig *config);
+const Engine *tune_workload(const Workload *workload, EngineConfig *best_config, double *best_time);
+void workload_key(const Workload *workload, char *key, size_t len);
+const Engine *load_tuning_profile(const char *path, const Workload *workload, EngineConfig *config);
+void save_tuning_profile(const char *path, const Workload *workload, const Engine *engine,
+                         const EngineConfig *config, double seconds_per_generation);
+int run_workload(const Workload *workload, const char *engine_name, const EngineConfig *overrides,
+                 const char *profile_path, bool tune, bool verify, bool print_final);
+int calibrate_parallel_crossover(int threads);
+int parallel_team_size(int rows, int cols, int requested);
+bool load_parallel_crossover(const char *path, int threads, int *cells_per_thread);
+void save_parallel_crossover(const char *path, int threads, int cells_per_thread);
+int sweep_schedules(const Workload *workload, const char *engine_name, const EngineConfig *overrides);
+bool publish_open(const char *name, int rows, int cols);
+void publish_generation(const char *grid, long long generation);
+void publish_close();
+int attach_published(const char *name, bool print_final);
+const Engine *default_engine();
+int serve_requests(const char *path, const char *profile_path);
+
+// Header of a shared-memory grid segment, followed by two slots of rows x cols cell bytes.
+// Each slot is guarded by a sequence lock: the writer makes its sequence odd while it copies a
+// generation in and even again when done, then points latest at it. Readers map the segment and
+// read a slot in place, retrying if its sequence was odd or changed while they read.
+typedef struct {
+    atomic_uint magic;
+    int32_t rows;
+    int32_t cols;
+    atomic_int latest;
+    atomic_int finished;
+    atomic_ullong sequence[2];
+    long long generation[2];
+} SharedGrid;
+
+// Segment the workload publishes every generation into (--publish)
+static const char *publish_name = NULL;
+static SharedGrid *published = NULL;
+static size_t published_bytes = 0;
+static char published_path[256];
+
+// Connection of a --serve client. Its connection thread and each of its queued jobs hold a
+// reference; the socket is closed when the last one is released. Whole messages are sent under
+// the client's own lock so lines never interleave, and a client that stops reading only ever
+// blocks senders to itself, for at most SERVICE_SEND_TIMEOUT before it is dropped.
+typedef struct {
+    int socket;
+    pthread_mutex_t send_lock;
+    atomic_int references;
+    bool broken;   // A send failed or timed out; later messages are discarded
+} ServiceClient;
+
+// World simulated by the --serve service. A world carries its own rule and boundary; the runner
+// thread installs them as the active ones before each slice of generations it runs.
+typedef struct ServiceJob {
+    struct ServiceJob *next;
+    long long id;
+    ServiceClient *client;   // Released once the result is sent
+    Workload workload;
+    const char *engine_name;   // NULL: tuned or default engine
+    char engine_text[32];
+    int threads;
+    Rule rule;
+    LtlRule ltl;
+    const Boundary *boundary;
+    bool print;
+    double weight;     // Share of the runner relative to other worlds (default 1)
+    double deadline;   // Seconds after submission the result is due (0: none)
+    double queued_at;
+    // Scheduling state, owned by the runner and updated under the service lock
+    const Engine *engine;
+    EngineConfig config;
+    char *grid;
+    int generations_done;
+    int slices;
+    double vruntime;            // Run time divided by weight; the fair share runs the lowest first
+    double generation_cost;     // Seconds per generation measured in the last slice
+    double first_slice_at;
+    double run_time;
+} ServiceJob;
+
+// Worlds and counters of the --serve service
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    ServiceJob *head;
+    ServiceJob *tail;
+    int depth;
+    bool stopping;
+    int listener;
+    long long next_id;
+    long long completed;
+    long long failed;
+    long long deadlines;
+    long long deadlines_missed;
+    double vclock;   // vruntime of the last world run; new worlds start here
+    double started;
+    double latency_total;
+    double latency_max;
+    double run_total;
+    double cell_generations;
+} service = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, false, -1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+             0, 0};
+
+// Rule applied by the workload engines (the performance report always runs B3/S23)
+static Rule active_rule = {1 << 3, (1 << 2) | (1 << 3), 2};
+
+// Larger-than-Life rule of the workload engines; replaces active_rule when its radius is set
+static LtlRule active_ltl = {0, false, 0, 0, 0, 0};
+
+// 4x4 neighbourhood -> 2x2 next-state table of the block engine and the rule it was built for
+static uint8_t block_table[1 << 16];
+static Rule block_table_rule = {0, 0, 0};
+
+// Hardware events sampled around benchmark runs (per thread, summed over the OpenMP team)
+#ifdef __linux__
+static const struct {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+} perf_events[] = {
+    {"L1D misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {"LLC misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"dTLB misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+#define PERF_EVENT_COUNT ((int)(sizeof(perf_events) / sizeof(perf_events[0])))
+static int *perf_fds = NULL;
+#else
+#define PERF_EVENT_COUNT 3
+#endif
+
+// Sense-reversing barrier: the last thread to arrive resets the count and flips the sense; the
+// others spin on the sense for BARRIER_SPINS polls and then sleep on it as a futex. The sense
+// cannot flip before every party has arrived, so each arriving thread reads its episode's sense
+// from the barrier instead of keeping a private copy.
+typedef struct {
+    atomic_int remaining;
+    atomic_int sense;
+    atomic_int sleepers;
+    int parties;
+} SpinBarrier;
+
+// Persistent pthread team; the calling thread is member 0 and the workers wait on the barrier
+// between jobs, so a job costs one barrier episode to start and one to finish
+typedef struct {
+    pthread_t *threads;
+    int size;
+    SpinBarrier barrier;
+    void (*job)(void *arg, int member, int team);
+    void *job_arg;
+    bool quit;
+} ThreadPool;
+
+static ThreadPool thread_pool;
+
+// Bounded work-stealing deque of tile indices (Chase-Lev without growth: tiles are only pushed
+// before the compute phase, so the owner pops at the bottom and thieves take from the top)
+typedef struct {
+    int *tiles;
+    atomic_int top;
+    atomic_int bottom;
+    char padding[64];
+} TileDeque;
+
+// Memo table entry: the 10x10 neighbourhood of an 8x8 tile (rows 0-5 in key_low, rows 6-9 in
+// key_high, 10 bits per row) and the tile's next state, one byte per row. key_high only uses
+// 40 bits, so all ones marks an empty entry.
+typedef struct {
+    uint64_t key_low;
+    uint64_t key_high;
+    uint64_t next;
+} MemoEntry;
+
+// Memo table size and the counts of the last memo run
+static int memo_table_bits = DEFAULT_MEMO_BITS;
+static long long memo_hits = 0;
+static long long memo_misses = 0;
+static size_t memo_table_bytes = 0;
+
+// Tile counts of the last stealing run
+static long long stealing_tiles_computed = 0;
+static long long stealing_tiles_skipped = 0;
+static long long stealing_tiles_stolen = 0;
+
+// Grid memory currently allocated and its high-water mark
+static size_t grid_bytes_in_use = 0;
+static size_t grid_bytes_peak = 0;
+
+// Where a grid buffer's pages come from
+typedef enum {
+    GRID_PAGES_SMALL,    // malloc
+    GRID_PAGES_THP,      // mmap, 2 MB aligned, madvise(MADV_HUGEPAGE)
+    GRID_PAGES_HUGETLB,  // mmap(MAP_HUGETLB) from the reserved huge page pool
+    GRID_PAGES_KINDS
+} GridPages;
+
+// Header stored in the GRID_HEADER bytes in front of every grid
+typedef struct {
+    size_t bytes;        // Cells requested by the current owner
+    size_t capacity;     // Usable bytes after the header
+    GridPages pages;
+} GridBlock;
+
+// Released buffers waiting for reuse, plus allocation statistics for the run report.
+// The pool is not thread-safe: grids are allocated and freed outside parallel regions.
+static GridBlock *grid_pool[GRID_POOL_SLOTS];
+static int grid_pool_count = 0;
+static bool grid_huge_pages = true;
+static int grid_fresh_allocations[GRID_PAGES_KINDS];
+static int grid_reused_allocations = 0;
+
+// Non-temporal output stores: -1 above the last-level cache size, 0 never, 1 always
+static int stream_mode = -1;
+
+// Minimum number of cells each thread must own before parallelism pays off (-1: not measured, 0: no limit)
+static int parallel_min_cells_per_thread = -1;
+
+static const Engine engines[] = {
+    {"serial", engine_serial, false, false, false, false, false, false, false, false, true},
+    {"rows", engine_parallel_rows, true, true, false, false, false, false, false, false, true},
+    {"tiled", engine_parallel_tiled, true, true, true, false, false, false, false, false, false},
+    {"collapse", engine_parallel_collapse, true, true, true, true, false, false, false, false, false},
+    {"blocked", engine_parallel_blocked, true, true, true, true, false, false, false, false, false},
+    {"inplace", engine_inplace, true, false, false, false, false, false, false, false, false},
+    {"runsum", engine_running_sum, true, true, false, false, false, false, false, false, false},
+    {"swar", engine_swar, true, true, false, false, true, false, false, false, false},
+    {"lut", engine_block_table, true, true, false, false, false, false, false, false, false},
+    {"bitpack", engine_bitpack, true, true, false, false, false, false, false, false, true},
+    {"morton", engine_morton, true, true, true, true, false, false, false, false, false},
+    {"pthreads", engine_pthreads, true, false, false, false, false, false, false, false, false},
+    {"stealing", engine_stealing, true, false, true, true, false, false, false, false, false},
+    {"memo", engine_memo, true, true, false, false, false, false, false, false, true},
+    {"pow2", engine_pow2, true, true, false, false, false, false, false, false, false},
+    {"halo", engine_halo, true, true, false, false, false, true, false, false, false},
+    {"generations", engine_generations, true, true, false, false, false, false, true, false, false},
+    {"genref", engine_generations_reference, true, true, false, false, false, false, true, false, false},
+    {"ltl", engine_ltl, true, true, false, false, false, false, false, true, false},
+    {"ltlref", engine_ltl_reference, true, true, false, false, false, false, false, true, false},
+};
+#define ENGINE_COUNT ((int)(sizeof(engines) / sizeof(engines[0])))
+
+static const Boundary boundaries[] = {
+    {"torus", fill_halo_torus},
+    {"dead", fill_halo_dead},
+    {"reflect", fill_halo_reflect},
+    {"klein", fill_halo_klein},
+};
+#define BOUNDARY_COUNT ((int)(sizeof(boundaries) / sizeof(boundaries[0])))
+
+// Boundary of the workload engines; every engine handles the torus, only bounded ones the others
+static const Boundary *active_boundary = &boundaries[0];
+
+// Schedule kinds known to the workload engines; dynamic is pinned to monotonic (OpenMP 4.5)
+// semantics so it can be compared with the nonmonotonic default of OpenMP 5.0
+static const struct {
+    const char *name;
+    omp_sched_t kind;
+} schedule_kinds[] = {
+    {"static", omp_sched_static},
+    {"dynamic", (omp_sched_t)(omp_sched_dynamic | omp_sched_monotonic)},
+    {"guided", omp_sched_guided},
+    {"auto", omp_sched_auto},
+    {"nonmonotonic:dynamic", omp_sched_dynamic},
+};
+#define SCHEDULE_KIND_COUNT ((int)(sizeof(schedule_kinds) / sizeof(schedule_kinds[0])))
+
+int main(int argc, char *argv[]) {
+    // Parse command line arguments; without workload options the TODO performance report runs
+    Workload workload = {GRID_SIZE, GRID_SIZE, 0.0f, ITERATIONS};
+    EngineConfig overrides = {0, 0, -1, 0, -1, NULL};
+    int crossover = -1;
+    const char *engine_name = NULL;
+    const char *profile_path = NULL;
+    bool workload_mode = false;
+    bool tune = false;
+    bool print_final_grid = false;
+    bool verify = false;
+    bool sweep = false;
+    bool aspect_sweep = false;
+    bool layout_sweep = false;
+    bool backend_compare = false;
+    const char *attach_name = NULL;
+    const char *serve_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--size") == 0) && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &workload.rows, &workload.cols) != 2 ||
+                workload.rows < 3 || workload.cols < 3) {
+                fprintf(stderr, "Invalid grid size '%s' (expected ROWSxCOLS, at least 3x3)\n", argv[i]);
+                return 1;
+            }
+            workload_mode = true;
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--density") == 0) {
+            // The density is optional: without one (next argument missing or another option) it is 0.3
+            workload.density = 0.3f;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                char *end;
+                workload.density = strtof(argv[++i], &end);
+                if (*end != '\0' || !(workload.density > 0.0f && workload.density <= 1.0f)) {
+                    fprintf(stderr, "Invalid density '%s' (expected a number above 0 and at most 1)\n", argv[i]);
+                    return 1;
+                }
+            }
+            workload_mode = true;
+        } else if ((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--iterations") == 0) && i + 1 < argc) {
+            workload.generations = atoi(argv[++i]);
+            if (workload.generations < 1) {
+                workload.generations = ITERATIONS;
+            }
+            workload_mode = true;
+        } else if ((strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--engine") == 0) && i + 1 < argc) {
+            engine_name = argv[++i];
+            workload_mode = true;
+        } else if ((strcmp(argv[i], "-T") == 0 || strcmp(argv[i], "--threads") == 0) && i + 1 < argc) {
+            overrides.threads = atoi(argv[++i]);
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--schedule") == 0 && i + 1 < argc) {
+            char kind[32] = {0};
+            int chunk = 0;
+            if (sscanf(argv[++i], "%31[^,],%d", kind, &chunk) < 1 || !parse_schedule(kind, &overrides.schedule)) {
+                fprintf(stderr, "Invalid schedule '%s' (expected KIND[,CHUNK])\n", argv[i]);
+                return 1;
+            }
+            overrides.chunk = chunk;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--tile") == 0 && i + 1 < argc) {
+            overrides.tile = atoi(argv[++i]);
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--prefetch") == 0 && i + 1 < argc) {
+            overrides.prefetch = atoi(argv[++i]);
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "auto") == 0) {
+                stream_mode = -1;
+            } else if (strcmp(argv[i], "on") == 0) {
+                stream_mode = 1;
+            } else if (strcmp(argv[i], "off") == 0) {
+                stream_mode = 0;
+            } else {
+                fprintf(stderr, "Invalid stream mode '%s' (expected auto, on or off)\n", argv[i]);
+                return 1;
+            }
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--memo-bits") == 0 && i + 1 < argc) {
+            memo_table_bits = atoi(argv[++i]);
+            if (memo_table_bits < 4 || memo_table_bits > 28) {
+                fprintf(stderr, "Memo table bits must be between 4 and 28\n");
+                return 1;
+            }
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--crossover") == 0 && i + 1 < argc) {
+            crossover = atoi(argv[++i]);
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--rule") == 0 && i + 1 < argc) {
+            i++;
+            if (argv[i][0] == 'R' || argv[i][0] == 'r') {
+                if (!parse_ltl_rule(argv[i], &active_ltl)) {
+                    fprintf(stderr, "Invalid Larger-than-Life rule '%s' (expected R5,C0,M1,S34..58,B34..45)\n", argv[i]);
+                    return 1;
+                }
+            } else if (!parse_rule(argv[i], &active_rule)) {
+                fprintf(stderr, "Invalid rule '%s' (expected B/S notation such as B3/S23)\n", argv[i]);
+                return 1;
+            }
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--boundary") == 0 && i + 1 < argc) {
+            active_boundary = find_boundary(argv[++i]);
+            if (active_boundary == NULL) {
+                fprintf(stderr, "Unknown boundary '%s' (see --help)\n", argv[i]);
+                return 1;
+            }
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (strcmp(argv[i], "--tune") == 0) {
+            tune = true;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            sweep = true;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--aspect-sweep") == 0) {
+            aspect_sweep = true;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--no-huge-pages") == 0) {
+            grid_huge_pages = false;
+        } else if (strcmp(argv[i], "--compare-backends") == 0) {
+            backend_compare = true;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--layout-sweep") == 0) {
+            layout_sweep = true;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--run") == 0) {
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--publish") == 0 && i + 1 < argc) {
+            publish_name = argv[++i];
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_path = argv[++i];
+        } else if (strcmp(argv[i], "--attach") == 0 && i + 1 < argc) {
+            attach_name = argv[++i];
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+            workload_mode = true;
+        } else if (strcmp(argv[i], "--print") == 0) {
+            print_final_grid = true;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage();
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option '%s' (see --help)\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (attach_name != NULL) {
+        return attach_published(attach_name, print_final_grid);
+    }
+    if (serve_path != NULL) {
+        if (crossover >= 0) {
+            parallel_min_cells_per_thread = crossover;
+        }
+        return serve_requests(serve_path, profile_path);
+    }
+
+    if (workload_mode) {
+        if (tune && engine_name != NULL) {
+            fprintf(stderr, "--tune chooses the engine itself; drop -e to tune, or --tune to run '%s'\n", engine_name);
+            return 1;
+        }
+        if (publish_name != NULL && (sweep || aspect_sweep || layout_sweep || backend_compare)) {
+            fprintf(stderr, "--publish runs a single workload, not sweeps or comparisons\n");
+            return 1;
+        }
+        if (crossover >= 0) {
+            parallel_min_cells_per_thread = crossover;
+        }
+        if ((active_boundary->fill != fill_halo_torus || active_rule.states > 2 || active_ltl.radius > 0) &&
+            (sweep || aspect_sweep || layout_sweep || backend_compare)) {
+            fprintf(stderr, "Sweeps and comparisons run two-state 3x3 rules on the torus only\n");
+            return 1;
+        }
+        if (active_boundary->fill != fill_halo_torus && (active_rule.states > 2 || active_ltl.radius > 0)) {
+            fprintf(stderr, "Generations and Larger-than-Life rules run on the torus only\n");
+            return 1;
+        }
+        if (sweep) {
+            return sweep_schedules(&workload, engine_name, &overrides);
+        }
+        if (aspect_sweep) {
+            return sweep_aspect_ratios(&workload, &overrides);
+        }
+        if (layout_sweep) {
+            return sweep_layouts(&workload, &overrides);
+        }
+        if (backend_compare) {
+            return compare_backends(&workload, &overrides);
+        }
+        return run_workload(&workload, engine_name, &overrides, profile_path, tune, verify, print_final_grid);
+    }
 
-int main() {
     double serial_time = 0, static_time = 0, guided_time = 0;
     double static_no_critical_time = 0, guided_no_critical_time = 0;
     
@@ -140,7 +784,7 @@ void initialize_grid(char grid[GRID_SIZE][GRID_SIZE]) {
     // Set all cells to dead
     for (int i = 0; i < GRID_SIZE; i++) {
         for (int j = 0; j < GRID_SIZE; j++) {
-            grid[i][j] = '.';
+            grid[i][j] = CELL_DEAD;
         }
     }
     
@@ -150,7 +794,7 @@ void initialize_grid(char grid[GRID_SIZE][GRID_SIZE]) {
     
     for (int i = 0; i < CENTER_SIZE; i++) {
         for (int j = 0; j < CENTER_SIZE; j++) {
-            grid[start_row + i][start_col + j] = '*';
+            grid[start_row + i][start_col + j] = CELL_LIVE;
         }
     }
 }
@@ -168,7 +812,7 @@ int count_neighbors(char grid[GRID_SIZE][GRID_SIZE], int row, int col) {
             int neighbor_row = (row + i + GRID_SIZE) % GRID_SIZE;
             int neighbor_col = (col + j + GRID_SIZE) % GRID_SIZE;
             
-            if (grid[neighbor_row][neighbor_col] == '*') {
+            if (grid[neighbor_row][neighbor_col] == CELL_LIVE) {
                 count++;
             }
         }
@@ -186,23 +830,23 @@ void simulate_serial(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][
                 int neighbors = count_neighbors(grid, i, j);
                 
                 // Apply the rules of the Game of Life
-                if (grid[i][j] == '*') {
+                if (grid[i][j] == CELL_LIVE) {
                     // Cell is alive
                     if (neighbors < 2 || neighbors > 3) {
                         // Dies from underpopulation or overpopulation
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     } else {
                         // Survives
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     }
                 } else {
                     // Cell is dead
                     if (neighbors == 3) {
                         // Reproduction
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     } else {
                         // Stays dead
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     }
                 }
             }
@@ -223,23 +867,23 @@ void simulate_parallel_static(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GR
                 int neighbors = count_neighbors(grid, i, j);
                 
                 // Apply the rules of the Game of Life
-                if (grid[i][j] == '*') {
+                if (grid[i][j] == CELL_LIVE) {
                     // Cell is alive
                     if (neighbors < 2 || neighbors > 3) {
                         // Dies from underpopulation or overpopulation
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     } else {
                         // Survives
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     }
                 } else {
                     // Cell is dead
                     if (neighbors == 3) {
                         // Reproduction
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     } else {
                         // Stays dead
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     }
                 }
             }
@@ -263,23 +907,23 @@ void simulate_parallel_guided(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GR
                 int neighbors = count_neighbors(grid, i, j);
                 
                 // Apply the rules of the Game of Life
-                if (grid[i][j] == '*') {
+                if (grid[i][j] == CELL_LIVE) {
                     // Cell is alive
                     if (neighbors < 2 || neighbors > 3) {
                         // Dies from underpopulation or overpopulation
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     } else {
                         // Survives
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     }
                 } else {
                     // Cell is dead
                     if (neighbors == 3) {
                         // Reproduction
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     } else {
                         // Stays dead
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     }
                 }
             }
@@ -303,23 +947,23 @@ void simulate_parallel_static_no_critical(char grid[GRID_SIZE][GRID_SIZE], char
                 int neighbors = count_neighbors(grid, i, j);
                 
                 // Apply the rules of the Game of Life
-                if (grid[i][j] == '*') {
+                if (grid[i][j] == CELL_LIVE) {
                     // Cell is alive
                     if (neighbors < 2 || neighbors > 3) {
                         // Dies from underpopulation or overpopulation
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     } else {
                         // Survives
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     }
                 } else {
                     // Cell is dead
                     if (neighbors == 3) {
                         // Reproduction
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     } else {
                         // Stays dead
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     }
                 }
             }
@@ -340,23 +984,23 @@ void simulate_parallel_guided_no_critical(char grid[GRID_SIZE][GRID_SIZE], char
                 int neighbors = count_neighbors(grid, i, j);
                 
                 // Apply the rules of the Game of Life
-                if (grid[i][j] == '*') {
+                if (grid[i][j] == CELL_LIVE) {
                     // Cell is alive
                     if (neighbors < 2 || neighbors > 3) {
                         // Dies from underpopulation or overpopulation
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     } else {
                         // Survives
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     }
                 } else {
                     // Cell is dead
                     if (neighbors == 3) {
                         // Reproduction
-                        next_grid[i][j] = '*';
+                        next_grid[i][j] = CELL_LIVE;
                     } else {
                         // Stays dead
-                        next_grid[i][j] = '.';
+                        next_grid[i][j] = CELL_DEAD;
                     }
                 }
             }
@@ -371,7 +1015,7 @@ void simulate_parallel_guided_no_critical(char grid[GRID_SIZE][GRID_SIZE], char
 void print_grid(char grid[GRID_SIZE][GRID_SIZE]) {
     for (int i = 0; i < GRID_SIZE; i++) {
         for (int j = 0; j < GRID_SIZE; j++) {
-            printf("%c", grid[i][j]);
+            printf("%c", grid[i][j] == CELL_LIVE ? '*' : '.');
         }
         printf("\n");
     }
@@ -380,8 +1024,9 @@ void print_grid(char grid[GRID_SIZE][GRID_SIZE]) {
 // Run a simulation with the given simulation function and measure its execution time
 double run_simulation(void (*simulate_func)(char[GRID_SIZE][GRID_SIZE], char[GRID_SIZE][GRID_SIZE]), 
                       const char* label, bool print_final) {
-    char grid[GRID_SIZE][GRID_SIZE];
-    char next_grid[GRID_SIZE][GRID_SIZE];
+    // Buffers come from the grid pool, so repeated runs recycle the same memory
+    char (*grid)[GRID_SIZE] = (char (*)[GRID_SIZE])alloc_grid(GRID_SIZE, GRID_SIZE);
+    char (*next_grid)[GRID_SIZE] = (char (*)[GRID_SIZE])alloc_grid(GRID_SIZE, GRID_SIZE);
     
     // Initialize grid
     initialize_grid(grid);
@@ -403,5 +1048,4167 @@ double run_simulation(void (*simulate_func)(char[GRID_SIZE][GRID_SIZE], char[GRI
         print_grid(grid);
     }
     
+    free_grid((char *)next_grid);
+    free_grid((char *)grid);
     return time_taken;
-}
\ No newline at end of file
+}
+// Print command line usage
+void print_usage() {
+    printf("Usage: game_of_life_text [OPTIONS]\n");
+    printf("\n");
+    printf("Without options the serial/static/guided performance report is run.\n");
+    printf("\n");
+    printf("Workload options:\n");
+    printf("  -s, --size ROWSxCOLS   Grid size (default %dx%d)\n", GRID_SIZE, GRID_SIZE);
+    printf("  -d, --density [D]      Random initial density, 0.3 without D (default: centered %dx%d block)\n", CENTER_SIZE,
+           CENTER_SIZE);
+    printf("  -i, --iterations N     Number of generations (default %d)\n", ITERATIONS);
+    printf("  -e, --engine NAME      Engine to run (");
+    for (int i = 0; i < ENGINE_COUNT; i++) {
+        printf("%s%s", engines[i].name, i + 1 < ENGINE_COUNT ? ", " : ")\n");
+    }
+    printf("  -T, --threads N        Number of OpenMP threads\n");
+    printf("      --rule B../S..     Life-like rule in B/S notation (default B3/S23), or a Generations rule\n");
+    printf("                         in B/S/C notation such as B2/S/C3 (generations and genref engines),\n");
+    printf("                         or a Larger-than-Life rule such as R5,C0,M1,S34..58,B34..45 (ltl and ltlref)\n");
+    printf("      --boundary NAME    Boundary condition (");
+    for (int i = 0; i < BOUNDARY_COUNT; i++) {
+        printf("%s%s", boundaries[i].name, i + 1 < BOUNDARY_COUNT ? ", " : "); only the halo engine supports all\n");
+    }
+    printf("      --schedule K[,C]   OpenMP schedule and chunk size (");
+    for (int i = 0; i < SCHEDULE_KIND_COUNT; i++) {
+        printf("%s%s", schedule_kinds[i].name, i + 1 < SCHEDULE_KIND_COUNT ? ", " : ")\n");
+    }
+    printf("      --tile N           Tile size of the tiled engine\n");
+    printf("      --stream MODE      Non-temporal output stores of the swar engine: auto (above the LLC size), on, off\n");
+    printf("      --prefetch N       Input rows prefetched ahead while streaming (default %d)\n", DEFAULT_PREFETCH_ROWS);
+    printf("      --memo-bits N      Memo engine table size: 2^N entries per thread (default %d)\n", DEFAULT_MEMO_BITS);
+    printf("      --tune             Probe engines and settings, store the fastest in the profile\n");
+    printf("      --sweep            Time every schedule kind against chunk sizes from 1 to a full band\n");
+    printf("      --aspect-sweep     Compare row, band and 2D-block engines on grids of the same area and growing width\n");
+    printf("      --layout-sweep     Compare row-major and Morton-tiled layouts (time and cache misses) at several sizes\n");
+    printf("      --compare-backends Compare the pthreads engine and its barrier with OpenMP at each thread count\n");
+    printf("      --run              Run the workload (tuned settings are used when profiled)\n");
+    printf("      --crossover N      Minimum cells per thread for parallel runs (0 disables the small-grid path)\n");
+    printf("      --profile FILE     Tuning profile (default ~/%s)\n", TUNE_PROFILE_FILE);
+    printf("      --no-huge-pages    Allocate grids on ordinary pages (to compare TLB misses)\n");
+    printf("      --publish NAME     Publish every generation to the POSIX shared-memory segment NAME\n");
+    printf("      --attach NAME      Follow a published run: report each generation read, then exit when it ends\n");
+    printf("      --serve PATH       Run as a service accepting simulation jobs on the Unix socket PATH\n");
+    printf("      --verify           Rerun the workload on the reference engine and compare the final grids\n");
+    printf("      --print            Print the final grid\n");
+    printf("  -h, --help             Display this help message\n");
+}
+
+// Map a fresh grid buffer, preferring explicit huge pages, then transparent huge pages, then malloc
+static GridBlock *map_grid_block(size_t capacity) {
+    size_t total = GRID_HEADER + capacity;
+    GridBlock *block = NULL;
+    GridPages pages = GRID_PAGES_SMALL;
+
+    if (grid_huge_pages && total >= HUGE_PAGE_SIZE) {
+        size_t huge_total = (total + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+        void *region = mmap(NULL, huge_total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (region != MAP_FAILED) {
+            block = region;
+            pages = GRID_PAGES_HUGETLB;
+            capacity = huge_total - GRID_HEADER;
+        }
+#endif
+#ifdef MADV_HUGEPAGE
+        if (block == NULL) {
+            // Over-map by one huge page and trim, so the buffer starts on a 2 MB boundary
+            char *region = mmap(NULL, huge_total + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region != MAP_FAILED) {
+                uintptr_t start = ((uintptr_t)region + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+                size_t head = start - (uintptr_t)region;
+                if (head > 0) munmap(region, head);
+                munmap((char *)start + huge_total, HUGE_PAGE_SIZE - head);
+                madvise((void *)start, huge_total, MADV_HUGEPAGE);
+                block = (GridBlock *)start;
+                pages = GRID_PAGES_THP;
+                capacity = huge_total - GRID_HEADER;
+            }
+        }
+#endif
+    }
+
+    if (block == NULL) {
+        block = malloc(total);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    block->capacity = capacity;
+    block->pages = pages;
+    grid_fresh_allocations[pages]++;
+    return block;
+}
+
+// Return a grid buffer's memory to the system
+static void unmap_grid_block(GridBlock *block) {
+    if (block->pages == GRID_PAGES_SMALL) {
+        free(block);
+    } else {
+        munmap(block, GRID_HEADER + block->capacity);
+    }
+}
+
+// Allocate a runtime-sized grid, exiting when memory runs out
+char *alloc_grid(int rows, int cols) {
+    char *grid = try_alloc_grid(rows, cols);
+    if (grid == NULL) {
+        fprintf(stderr, "Failed to allocate a %dx%d grid\n", rows, cols);
+        exit(1);
+    }
+    return grid;
+}
+
+// Allocate a runtime-sized grid, returning NULL when memory runs out. Buffers come from the pool
+// when a released one is large enough without wasting more than half of it.
+char *try_alloc_grid(int rows, int cols) {
+    size_t bytes = (size_t)rows * cols;
+    GridBlock *block = NULL;
+    int best = -1;
+
+    for (int i = 0; i < grid_pool_count; i++) {
+        size_t capacity = grid_pool[i]->capacity;
+        if (capacity >= bytes && capacity / 2 <= bytes &&
+            (best < 0 || capacity < grid_pool[best]->capacity)) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        block = grid_pool[best];
+        grid_pool[best] = grid_pool[--grid_pool_count];
+        grid_reused_allocations++;
+    } else {
+        block = map_grid_block(bytes);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    // Track grid memory so runs can report their peak footprint
+    block->bytes = bytes;
+    grid_bytes_in_use += bytes;
+    if (grid_bytes_in_use > grid_bytes_peak) {
+        grid_bytes_peak = grid_bytes_in_use;
+    }
+    return (char *)block + GRID_HEADER;
+}
+
+// Release a grid obtained from alloc_grid back to the pool; when the pool is full the
+// smallest buffer (pooled or released) goes back to the system
+void free_grid(char *grid) {
+    if (grid == NULL) {
+        return;
+    }
+
+    GridBlock *block = (GridBlock *)(grid - GRID_HEADER);
+    grid_bytes_in_use -= block->bytes;
+
+    if (grid_pool_count < GRID_POOL_SLOTS) {
+        grid_pool[grid_pool_count++] = block;
+        return;
+    }
+
+    int smallest = 0;
+    for (int i = 1; i < grid_pool_count; i++) {
+        if (grid_pool[i]->capacity < grid_pool[smallest]->capacity) {
+            smallest = i;
+        }
+    }
+    if (grid_pool[smallest]->capacity < block->capacity) {
+        GridBlock *evicted = grid_pool[smallest];
+        grid_pool[smallest] = block;
+        block = evicted;
+    }
+    unmap_grid_block(block);
+}
+
+// Release every pooled buffer
+void drain_grid_pool() {
+    while (grid_pool_count > 0) {
+        unmap_grid_block(grid_pool[--grid_pool_count]);
+    }
+}
+
+// Print how grid buffers were obtained
+void print_grid_pool_report() {
+    printf("  Grid buffers: %d reused, %d fresh (%d hugetlb, %d transparent huge page, %d small-page)\n",
+           grid_reused_allocations,
+           grid_fresh_allocations[GRID_PAGES_HUGETLB] + grid_fresh_allocations[GRID_PAGES_THP] +
+               grid_fresh_allocations[GRID_PAGES_SMALL],
+           grid_fresh_allocations[GRID_PAGES_HUGETLB], grid_fresh_allocations[GRID_PAGES_THP],
+           grid_fresh_allocations[GRID_PAGES_SMALL]);
+}
+
+// Initialize a runtime-sized grid with a random fill or the centered block
+void initialize_workload_grid(char *grid, const Workload *workload) {
+    int rows = workload->rows;
+    int cols = workload->cols;
+
+    memset(grid, CELL_DEAD, (size_t)rows * cols);
+
+    if (workload->density > 0) {
+        // Fixed seed so every engine and every probe sees the same world
+        srand(WORKLOAD_SEED);
+        for (size_t i = 0; i < (size_t)rows * cols; i++) {
+            if ((float)rand() / RAND_MAX < workload->density) {
+                grid[i] = CELL_LIVE;
+            }
+        }
+        return;
+    }
+
+    int size_rows = rows < CENTER_SIZE ? rows : CENTER_SIZE;
+    int size_cols = cols < CENTER_SIZE ? cols : CENTER_SIZE;
+    int start_row = (rows - size_rows) / 2;
+    int start_col = (cols - size_cols) / 2;
+
+    for (int i = 0; i < size_rows; i++) {
+        memset(grid + (size_t)(start_row + i) * cols + start_col, CELL_LIVE, size_cols);
+    }
+}
+
+// Count the live cells of a runtime-sized grid
+int count_live(const char *grid, int rows, int cols) {
+    int count = 0;
+    for (size_t i = 0; i < (size_t)rows * cols; i++) {
+        count += grid[i] == CELL_LIVE;
+    }
+    return count;
+}
+
+// Printed form of a cell; dying states of Generations rules print as their hexadecimal state number
+static inline char cell_symbol(int state) {
+    return state == CELL_LIVE ? '*' : state == CELL_DEAD ? '.' : "0123456789abcdef"[state];
+}
+
+// Print a runtime-sized grid
+void print_workload_grid(const char *grid, int rows, int cols) {
+    char *line = malloc((size_t)cols + 1);
+    if (line == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            line[j] = cell_symbol(grid[(size_t)i * cols + j]);
+        }
+        line[cols] = '\n';
+        fwrite(line, 1, (size_t)cols + 1, stdout);
+    }
+    free(line);
+}
+
+// Compute cells [col_begin, col_end) of one row of the next generation (toroidal boundary)
+static inline void update_cells(const char *up, const char *mid, const char *down, char *out,
+                                int cols, int col_begin, int col_end) {
+    for (int j = col_begin; j < col_end; j++) {
+        int left = (j == 0) ? cols - 1 : j - 1;
+        int right = (j == cols - 1) ? 0 : j + 1;
+        int neighbors = up[left] + up[j] + up[right] +
+                        mid[left] + mid[right] +
+                        down[left] + down[j] + down[right];
+
+        // Survival and reproduction counts come from the active rule
+        if (mid[j] == CELL_LIVE) {
+            out[j] = (active_rule.survive >> neighbors) & 1;
+        } else {
+            out[j] = (active_rule.birth >> neighbors) & 1;
+        }
+    }
+}
+
+static inline void update_row(const char *grid, char *next_grid, int rows, int cols,
+                              int row, int col_begin, int col_end) {
+    const char *up = grid + (size_t)(row == 0 ? rows - 1 : row - 1) * cols;
+    const char *mid = grid + (size_t)row * cols;
+    const char *down = grid + (size_t)(row == rows - 1 ? 0 : row + 1) * cols;
+
+    update_cells(up, mid, down, next_grid + (size_t)row * cols, cols, col_begin, col_end);
+}
+
+// Serial engine: reference implementation for the tuner
+void engine_serial(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    char *current = grid;
+    char *next = scratch;
+
+    for (int iter = 0; iter < generations; iter++) {
+        for (int i = 0; i < rows; i++) {
+            update_row(current, next, rows, cols, i, 0, cols);
+        }
+
+        // Swap buffers instead of copying the whole grid back
+        char *tmp = current;
+        current = next;
+        next = tmp;
+        if (config->on_generation != NULL) {
+            config->on_generation(current, iter + 1);
+        }
+    }
+
+    if (current != grid) {
+        memcpy(grid, current, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Parallel engine over rows with the OpenMP schedule taken from the configuration
+void engine_parallel_rows(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    // One parallel region for all generations; the implicit barrier of the loop separates them
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                update_row(current, next, rows, cols, i, 0, cols);
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+            // The barrier closing single keeps the observed grid stable until the callback returns
+            if (config->on_generation != NULL) {
+                #pragma omp single
+                config->on_generation(current, iter + 1);
+            }
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Parallel engine over bands of tile rows, walking each band in tile-wide column blocks
+void engine_parallel_tiled(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int tile = config->tile > 0 ? config->tile : DEFAULT_TILE_SIZE;
+    int bands = (rows + tile - 1) / tile;
+    int team = parallel_team_size(rows, cols, config->threads);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int band = 0; band < bands; band++) {
+                int row_begin = band * tile;
+                int row_end = row_begin + tile < rows ? row_begin + tile : rows;
+
+                // Keep the three active rows of a column block in cache
+                for (int col_begin = 0; col_begin < cols; col_begin += tile) {
+                    int col_end = col_begin + tile < cols ? col_begin + tile : cols;
+                    for (int i = row_begin; i < row_end; i++) {
+                        update_row(current, next, rows, cols, i, col_begin, col_end);
+                    }
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Compute one row segment without wraparound inside the loop: the edge columns go through
+// update_row and the interior is a straight strip the compiler can vectorize
+static inline void update_row_strip(const char *grid, char *next_grid, int rows, int cols,
+                                    int row, int col_begin, int col_end) {
+    if (col_begin == 0) {
+        update_row(grid, next_grid, rows, cols, row, 0, 1);
+        col_begin = 1;
+    }
+    if (col_end == cols) {
+        update_row(grid, next_grid, rows, cols, row, cols - 1, cols);
+        col_end = cols - 1;
+    }
+
+    const char *up = grid + (size_t)(row == 0 ? rows - 1 : row - 1) * cols;
+    const char *mid = grid + (size_t)row * cols;
+    const char *down = grid + (size_t)(row == rows - 1 ? 0 : row + 1) * cols;
+    char *out = next_grid + (size_t)row * cols;
+    unsigned int birth = active_rule.birth;
+    unsigned int survive = active_rule.survive;
+
+    #pragma omp simd
+    for (int j = col_begin; j < col_end; j++) {
+        unsigned int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                                 mid[j - 1] + mid[j + 1] +
+                                 down[j - 1] + down[j] + down[j + 1];
+        out[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+    }
+}
+
+// Parallel engine over tile x tile blocks, distributed with collapse(2) over block rows and block columns
+void engine_parallel_collapse(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int tile = config->tile > 0 ? config->tile : DEFAULT_TILE_SIZE;
+    int row_blocks = (rows + tile - 1) / tile;
+    int col_blocks = (cols + tile - 1) / tile;
+    int team = parallel_team_size(rows, cols, config->threads);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for collapse(2) schedule(runtime)
+            for (int row_block = 0; row_block < row_blocks; row_block++) {
+                for (int col_block = 0; col_block < col_blocks; col_block++) {
+                    int row_begin = row_block * tile;
+                    int row_end = row_begin + tile < rows ? row_begin + tile : rows;
+                    int col_begin = col_block * tile;
+                    int col_end = col_begin + tile < cols ? col_begin + tile : cols;
+
+                    for (int i = row_begin; i < row_end; i++) {
+                        update_row(current, next, rows, cols, i, col_begin, col_end);
+                    }
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Parallel engine over the same tile x tile blocks, flattened by hand and computed in vectorizable row strips
+void engine_parallel_blocked(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int tile = config->tile > 0 ? config->tile : DEFAULT_TILE_SIZE;
+    int row_blocks = (rows + tile - 1) / tile;
+    int col_blocks = (cols + tile - 1) / tile;
+    int blocks = row_blocks * col_blocks;
+    int team = parallel_team_size(rows, cols, config->threads);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int block = 0; block < blocks; block++) {
+                int row_begin = (block / col_blocks) * tile;
+                int row_end = row_begin + tile < rows ? row_begin + tile : rows;
+                int col_begin = (block % col_blocks) * tile;
+                int col_end = col_begin + tile < cols ? col_begin + tile : cols;
+
+                for (int i = row_begin; i < row_end; i++) {
+                    update_row_strip(current, next, rows, cols, i, col_begin, col_end);
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Compute a full row of the next generation from three explicit rows (toroidal in the columns)
+static inline void update_line(const char *up, const char *mid, const char *down, char *out, int cols) {
+    for (int e = 0; e < 2; e++) {
+        int j = e == 0 ? 0 : cols - 1;
+        int left = (j == 0) ? cols - 1 : j - 1;
+        int right = (j == cols - 1) ? 0 : j + 1;
+        int neighbors = up[left] + up[j] + up[right] +
+                        mid[left] + mid[right] +
+                        down[left] + down[j] + down[right];
+        out[j] = ((mid[j] ? active_rule.survive : active_rule.birth) >> neighbors) & 1;
+    }
+
+    unsigned int birth = active_rule.birth;
+    unsigned int survive = active_rule.survive;
+
+    #pragma omp simd
+    for (int j = 1; j < cols - 1; j++) {
+        unsigned int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                                 mid[j - 1] + mid[j + 1] +
+                                 down[j - 1] + down[j] + down[j + 1];
+        out[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+    }
+}
+
+// In-place engine: each thread owns a contiguous band of rows and overwrites it row by row,
+// keeping the original previous and current rows in two rolling line buffers. The original
+// first and last row of every band are saved before the band is touched, so neighbouring bands
+// (and the torus wrap) still see the old generation. Boundary rows alternate between two sets
+// by generation parity, which leaves one barrier per generation. Extra memory: 6 rows per thread.
+void engine_inplace(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int team = parallel_team_size(rows, cols, config->threads);
+    if (team > rows) {
+        team = rows;
+    }
+
+    // Per thread: boundary[parity][first, last] plus the two rolling line buffers
+    char *buffers = alloc_grid(6 * team, cols);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        int threads = omp_get_num_threads();
+        int t = omp_get_thread_num();
+        int band_begin = (int)((long long)rows * t / threads);
+        int band_end = (int)((long long)rows * (t + 1) / threads);
+        char *lines[2] = {buffers + (size_t)(6 * t + 4) * cols, buffers + (size_t)(6 * t + 5) * cols};
+
+        for (int iter = 0; iter < generations; iter++) {
+            int parity = iter & 1;
+            char *first = buffers + (size_t)(6 * t + 2 * parity) * cols;
+            char *last = first + cols;
+
+            // Save the original edge rows of this band before anyone overwrites them
+            memcpy(first, grid + (size_t)band_begin * cols, cols);
+            memcpy(last, grid + (size_t)(band_end - 1) * cols, cols);
+
+            #pragma omp barrier
+
+            int before = (t + threads - 1) % threads;
+            int after = (t + 1) % threads;
+            const char *prev = buffers + (size_t)(6 * before + 2 * parity + 1) * cols;
+            const char *after_first = buffers + (size_t)(6 * after + 2 * parity) * cols;
+
+            for (int i = band_begin; i < band_end; i++) {
+                char *row = grid + (size_t)i * cols;
+                char *cur = lines[i & 1];
+                const char *down = (i + 1 < band_end) ? row + cols : after_first;
+
+                memcpy(cur, row, cols);
+                update_line(prev, cur, down, row, cols);
+                prev = cur;
+            }
+        }
+    }
+
+    free_grid(buffers);
+}
+
+// Separable neighbour count for one row: vertical 3-cell sums per column first, then a sliding
+// horizontal 3-wide window over them. Each cell is loaded about three times instead of nine and
+// both loops are branch-free. sums must hold cols + 2 entries; sums[0] and sums[cols + 1] are the
+// wrapped halo columns.
+static inline void update_row_running_sum(const char *up, const char *mid, const char *down, char *out,
+                                          unsigned char *sums, int cols) {
+    unsigned char *column = sums + 1;
+
+    #pragma omp simd
+    for (int j = 0; j < cols; j++) {
+        column[j] = up[j] + mid[j] + down[j];
+    }
+    column[-1] = column[cols - 1];
+    column[cols] = column[0];
+
+    // The window includes the cell itself, so subtract it to get the neighbour count
+    unsigned int birth = active_rule.birth;
+    unsigned int survive = active_rule.survive;
+
+    #pragma omp simd
+    for (int j = 0; j < cols; j++) {
+        unsigned int neighbors = column[j - 1] + column[j] + column[j + 1] - mid[j];
+        out[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+    }
+}
+
+// Parallel engine over rows using the separable running-sum kernel
+void engine_running_sum(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+    char *sums = alloc_grid(team, cols + 2);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        unsigned char *row_sums = (unsigned char *)sums + (size_t)omp_get_thread_num() * (cols + 2);
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                const char *up = current + (size_t)(i == 0 ? rows - 1 : i - 1) * cols;
+                const char *down = current + (size_t)(i == rows - 1 ? 0 : i + 1) * cols;
+                update_row_running_sum(up, current + (size_t)i * cols, down, next + (size_t)i * cols, row_sums, cols);
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(sums);
+    free_grid(scratch);
+}
+
+#define SWAR_ONES 0x0101010101010101ULL
+
+// Load 8 consecutive cells as one word (unaligned)
+static inline uint64_t load_cells(const char *cells) {
+    uint64_t word;
+    memcpy(&word, cells, sizeof(word));
+    return word;
+}
+
+// Per-byte equality with a small constant: 0x01 in every byte of x equal to value, 0x00 elsewhere.
+// Only valid while every byte of x and value stays below 16, which holds for neighbour counts.
+static inline uint64_t swar_equal(uint64_t x, uint64_t value) {
+    uint64_t diff = x ^ (value * SWAR_ONES);
+    return ((diff | (diff >> 1) | (diff >> 2) | (diff >> 3)) & SWAR_ONES) ^ SWAR_ONES;
+}
+
+// SWAR kernel for one row: eight 0/1 cells per uint64_t. Each byte of the sum of the nine shifted
+// words is at most 9, so the additions never carry into the neighbouring cell. The rule is applied
+// with one per-byte equality test per neighbour count it contains. The edge columns and the tail
+// that does not fill a word fall back to update_cells. The row is written to out; when ahead is
+// not NULL, that input row is prefetched one cache line per 64 cells.
+static inline void update_row_swar(const char *grid, char *out, int rows, int cols, int row, const char *ahead) {
+    const char *up = grid + (size_t)(row == 0 ? rows - 1 : row - 1) * cols;
+    const char *mid = grid + (size_t)row * cols;
+    const char *down = grid + (size_t)(row == rows - 1 ? 0 : row + 1) * cols;
+    int birth_counts[9], survive_counts[9];
+    int birth_n = 0, survive_n = 0;
+    int j = 1;
+
+    for (int n = 0; n <= 8; n++) {
+        if ((active_rule.birth >> n) & 1) birth_counts[birth_n++] = n;
+        if ((active_rule.survive >> n) & 1) survive_counts[survive_n++] = n;
+    }
+
+    update_cells(up, mid, down, out, cols, 0, 1);
+
+    for (; j + 8 < cols; j += 8) {
+        if (ahead != NULL && ((j - 1) & 63) == 0) {
+            __builtin_prefetch(ahead + j - 1);
+        }
+
+        uint64_t center = load_cells(mid + j);
+        uint64_t neighbors = load_cells(up + j - 1) + load_cells(up + j) + load_cells(up + j + 1) +
+                             load_cells(mid + j - 1) + load_cells(mid + j + 1) +
+                             load_cells(down + j - 1) + load_cells(down + j) + load_cells(down + j + 1);
+        uint64_t born = 0, kept = 0;
+
+        for (int k = 0; k < birth_n; k++) born |= swar_equal(neighbors, birth_counts[k]);
+        for (int k = 0; k < survive_n; k++) kept |= swar_equal(neighbors, survive_counts[k]);
+
+        uint64_t next = (born & (center ^ SWAR_ONES)) | (kept & center);
+        memcpy(out + j, &next, sizeof(next));
+    }
+
+    update_cells(up, mid, down, out, cols, j, cols);
+}
+
+// Size of the last-level cache, or FALLBACK_LLC_BYTES when the system does not report it
+size_t last_level_cache_bytes() {
+    static size_t cached = 0;
+
+    if (cached == 0) {
+        long bytes = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (bytes <= 0) bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+        cached = bytes > 0 ? (size_t)bytes : FALLBACK_LLC_BYTES;
+    }
+    return cached;
+}
+
+// Whether a grid is large enough for non-temporal output stores to pay off: an output grid that
+// does not fit in the last-level cache is evicted anyway, so reading its lines first is wasted
+bool grid_streams(int rows, int cols) {
+    if (stream_mode >= 0) {
+        return stream_mode == 1;
+    }
+    return (size_t)rows * cols > last_level_cache_bytes();
+}
+
+// Copy a finished row to the output grid with non-temporal stores, bypassing the cache and the
+// read-for-ownership of the destination lines; the unaligned head and tail use ordinary stores
+static inline void stream_cells(char *dst, const char *src, int n) {
+#ifdef __SSE2__
+    int head = (int)((16 - ((uintptr_t)dst & 15)) & 15);
+    int j;
+
+    if (head > n) head = n;
+    memcpy(dst, src, head);
+    for (j = head; j + 16 <= n; j += 16) {
+        _mm_stream_si128((__m128i *)(dst + j), _mm_loadu_si128((const __m128i *)(src + j)));
+    }
+    memcpy(dst + j, src + j, n - j);
+#else
+    memcpy(dst, src, n);
+#endif
+}
+
+// Order this thread's non-temporal stores before the generation barrier
+static inline void stream_fence() {
+#ifdef __SSE2__
+    _mm_sfence();
+#endif
+}
+
+// Parallel engine over rows using the SWAR byte kernel. On grids larger than the last-level cache
+// each row is computed into a per-thread line buffer, streamed out with non-temporal stores, and
+// the input row config->prefetch rows ahead is prefetched.
+void engine_swar(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+    bool streaming = grid_streams(rows, cols);
+    char *lines = streaming ? alloc_grid(team, cols) : NULL;
+    int prefetch = config->prefetch;
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+        char *line = streaming ? lines + (size_t)omp_get_thread_num() * cols : NULL;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime) nowait
+            for (int i = 0; i < rows; i++) {
+                if (streaming) {
+                    const char *ahead = prefetch > 0 ? current + (size_t)((i + 1 + prefetch) % rows) * cols : NULL;
+                    update_row_swar(current, line, rows, cols, i, ahead);
+                    stream_cells(next + (size_t)i * cols, line, cols);
+                } else {
+                    update_row_swar(current, next + (size_t)i * cols, rows, cols, i, NULL);
+                }
+            }
+
+            if (streaming) {
+                stream_fence();
+            }
+            #pragma omp barrier
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(lines);
+    free_grid(scratch);
+}
+
+// Parse a rule in B/S notation such as "B3/S23", or B/S/C notation such as "B2/S/C3" for a
+// Generations rule (case-insensitive, any order)
+bool parse_rule(const char *text, Rule *rule) {
+    Rule parsed = {0, 0, 2};
+    uint16_t *target = NULL;
+    bool seen_birth = false, seen_survive = false;
+
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == 'B' || *c == 'b') {
+            target = &parsed.birth;
+            seen_birth = true;
+        } else if (*c == 'S' || *c == 's') {
+            target = &parsed.survive;
+            seen_survive = true;
+        } else if (*c == 'C' || *c == 'c') {
+            char *end;
+            long states = strtol(c + 1, &end, 10);
+            if (end == c + 1 || states < 2 || states > MAX_RULE_STATES) {
+                return false;
+            }
+            parsed.states = (uint8_t)states;
+            target = NULL;
+            c = end - 1;
+        } else if (*c >= '0' && *c <= '8' && target != NULL) {
+            *target |= 1 << (*c - '0');
+        } else if (*c != '/') {
+            return false;
+        }
+    }
+
+    if (!seen_birth || !seen_survive) {
+        return false;
+    }
+    *rule = parsed;
+    return true;
+}
+
+// Format a rule in B/S notation
+void format_rule(const Rule *rule, char *text, size_t len) {
+    size_t pos = 0;
+
+    text[pos++] = 'B';
+    for (int n = 0; n <= 8 && pos + 4 < len; n++) {
+        if ((rule->birth >> n) & 1) text[pos++] = '0' + n;
+    }
+    text[pos++] = '/';
+    text[pos++] = 'S';
+    for (int n = 0; n <= 8 && pos + 1 < len; n++) {
+        if ((rule->survive >> n) & 1) text[pos++] = '0' + n;
+    }
+    text[pos] = '\0';
+    if (rule->states > 2) {
+        snprintf(text + pos, len - pos, "/C%d", rule->states);
+    }
+}
+
+// Precompute the next state of the inner 2x2 cells for every 4x4 neighbourhood under a rule.
+// Index bits: four 4-bit column codes, leftmost column in the top nibble; within a code the
+// top row is bit 3. Result bits: (row 1, col 1), (1, 2), (2, 1), (2, 2) from bit 0 upwards.
+void build_block_table(const Rule *rule) {
+    for (int index = 0; index < (1 << 16); index++) {
+        int cells[4][4];
+        uint8_t result = 0;
+
+        for (int c = 0; c < 4; c++) {
+            int code = (index >> (12 - 4 * c)) & 0xF;
+            for (int r = 0; r < 4; r++) {
+                cells[r][c] = (code >> (3 - r)) & 1;
+            }
+        }
+
+        for (int r = 1; r <= 2; r++) {
+            for (int c = 1; c <= 2; c++) {
+                int neighbors = -cells[r][c];
+                for (int dr = -1; dr <= 1; dr++) {
+                    for (int dc = -1; dc <= 1; dc++) {
+                        neighbors += cells[r + dr][c + dc];
+                    }
+                }
+
+                int next = ((cells[r][c] ? rule->survive : rule->birth) >> neighbors) & 1;
+                result |= next << ((r - 1) * 2 + (c - 1));
+            }
+        }
+
+        block_table[index] = result;
+    }
+
+    block_table_rule = *rule;
+}
+
+// Lookup-table engine: every lookup turns a 4x4 neighbourhood into the 2x2 next state of its center,
+// so a pair of rows is advanced two cells at a time with no arithmetic on the cells. For each pair
+// of rows a vertical 4-bit code per column is built once, and each lookup index is four adjacent
+// codes. An odd last row or column falls back to update_row.
+void engine_block_table(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    if (block_table_rule.birth != active_rule.birth || block_table_rule.survive != active_rule.survive ||
+        (block_table_rule.birth == 0 && block_table_rule.survive == 0)) {
+        build_block_table(&active_rule);
+    }
+
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+    int pairs = rows / 2;
+    int even_cols = cols & ~1;
+    char *codes = alloc_grid(team, cols + 3);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        // code[-1] .. code[cols + 1] with the wrapped columns on both ends
+        uint8_t *code = (uint8_t *)codes + (size_t)omp_get_thread_num() * (cols + 3) + 1;
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int pair = 0; pair < pairs; pair++) {
+                int i = pair * 2;
+                const char *r0 = current + (size_t)(i == 0 ? rows - 1 : i - 1) * cols;
+                const char *r1 = current + (size_t)i * cols;
+                const char *r2 = current + (size_t)(i + 1) * cols;
+                const char *r3 = current + (size_t)(i + 2 == rows ? 0 : i + 2) * cols;
+                char *out1 = next + (size_t)i * cols;
+                char *out2 = out1 + cols;
+
+                for (int j = 0; j < cols; j++) {
+                    code[j] = (uint8_t)((r0[j] << 3) | (r1[j] << 2) | (r2[j] << 1) | r3[j]);
+                }
+                code[-1] = code[cols - 1];
+                code[cols] = code[0];
+                code[cols + 1] = code[1];
+
+                for (int j = 0; j < even_cols; j += 2) {
+                    uint8_t result = block_table[(code[j - 1] << 12) | (code[j] << 8) | (code[j + 1] << 4) | code[j + 2]];
+                    out1[j] = result & 1;
+                    out1[j + 1] = (result >> 1) & 1;
+                    out2[j] = (result >> 2) & 1;
+                    out2[j + 1] = (result >> 3) & 1;
+                }
+
+                if (even_cols != cols) {
+                    update_row(current, next, rows, cols, i, cols - 1, cols);
+                    update_row(current, next, rows, cols, i + 1, cols - 1, cols);
+                }
+            }
+
+            if (rows % 2 != 0) {
+                #pragma omp single
+                update_row(current, next, rows, cols, rows - 1, 0, cols);
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(codes);
+    free_grid(scratch);
+}
+
+// Build the bitwise network for a rule, picking a hand-written one for common rules
+static void build_rule_network(const Rule *rule, RuleNetwork *network) {
+    network->kind = RULE_NETWORK_GENERIC;
+    if (rule->birth == (1 << 3) && rule->survive == ((1 << 2) | (1 << 3))) {
+        network->kind = RULE_NETWORK_CONWAY;
+    } else if (rule->birth == ((1 << 3) | (1 << 6)) && rule->survive == ((1 << 2) | (1 << 3))) {
+        network->kind = RULE_NETWORK_HIGHLIFE;
+    }
+
+    network->birth_low = rule->birth & 0xF;
+    network->birth_high = (rule->birth >> 4) & 0xF;
+    network->birth_eight = (rule->birth >> 8) & 1;
+    network->survive_low = rule->survive & 0xF;
+    network->survive_high = (rule->survive >> 4) & 0xF;
+    network->survive_eight = (rule->survive >> 8) & 1;
+}
+
+// Cells whose neighbour count is in the selected set, from the decoded low planes and planes 2 and 3
+static inline uint64_t match_counts(const uint64_t low[4], uint64_t b2, uint64_t b3,
+                                    uint8_t select_low, uint8_t select_high, bool eight) {
+    uint64_t below_four = 0, above_three = 0;
+
+    for (int k = 0; k < 4; k++) {
+        if ((select_low >> k) & 1) below_four |= low[k];
+        if ((select_high >> k) & 1) above_three |= low[k];
+    }
+    return (((below_four & ~b2) | (above_three & b2)) & ~b3) | (eight ? b3 : 0);
+}
+
+// Apply the rule network to 64 cells given their state and neighbour-count planes
+static inline uint64_t apply_rule_network(const RuleNetwork *network, uint64_t alive,
+                                          uint64_t b0, uint64_t b1, uint64_t b2, uint64_t b3) {
+    switch (network->kind) {
+        case RULE_NETWORK_CONWAY:
+            // Count 3, or count 2 while alive
+            return b1 & ~b2 & ~b3 & (b0 | alive);
+        case RULE_NETWORK_HIGHLIFE:
+            // As Conway, plus births at count 6
+            return ~b3 & ((b1 & ~b2 & (b0 | alive)) | (~alive & b2 & b1 & ~b0));
+        default: {
+            uint64_t low[4] = {~b1 & ~b0, ~b1 & b0, b1 & ~b0, b1 & b0};
+            uint64_t born = match_counts(low, b2, b3, network->birth_low, network->birth_high, network->birth_eight);
+            uint64_t kept = match_counts(low, b2, b3, network->survive_low, network->survive_high, network->survive_eight);
+            return (born & ~alive) | (kept & alive);
+        }
+    }
+}
+
+// Packed rows: bit b of word w is column w * 64 + b; padding bits past the last column stay zero.
+// The west view puts the left neighbour of every cell at the cell's bit, the east view the right one.
+static inline uint64_t packed_west(const uint64_t *row, int w, int words, int cols) {
+    uint64_t view = row[w] << 1;
+    if (w > 0) {
+        view |= row[w - 1] >> 63;
+    } else {
+        view |= (row[words - 1] >> ((cols - 1) & 63)) & 1;
+    }
+    return view;
+}
+
+static inline uint64_t packed_east(const uint64_t *row, int w, int words, int cols) {
+    uint64_t view = row[w] >> 1;
+    if (w < words - 1) {
+        view |= row[w + 1] << 63;
+    } else {
+        view |= (row[0] & 1) << ((cols - 1) & 63);
+    }
+    return view;
+}
+
+// Pack a 0/1 byte grid into rows of 64-bit words
+static void pack_grid(const char *grid, uint64_t *packed, int rows, int cols, int words, int team) {
+    #pragma omp parallel for schedule(static) num_threads(team) if(team > 1)
+    for (int i = 0; i < rows; i++) {
+        uint64_t *row = packed + (size_t)i * words;
+        memset(row, 0, (size_t)words * sizeof(uint64_t));
+        for (int j = 0; j < cols; j++) {
+            row[j >> 6] |= (uint64_t)(grid[(size_t)i * cols + j] & 1) << (j & 63);
+        }
+    }
+}
+
+// Unpack one row of 64-bit words into 0/1 bytes
+static inline void unpack_row(const uint64_t *row, char *out, int cols) {
+    for (int j = 0; j < cols; j++) {
+        out[j] = (row[j >> 6] >> (j & 63)) & 1;
+    }
+}
+
+// Unpack rows of 64-bit words into a 0/1 byte grid
+static void unpack_grid(const uint64_t *packed, char *grid, int rows, int cols, int words, int team) {
+    #pragma omp parallel for schedule(static) num_threads(team) if(team > 1)
+    for (int i = 0; i < rows; i++) {
+        unpack_row(packed + (size_t)i * words, grid + (size_t)i * cols, cols);
+    }
+}
+
+// Unpack the current generation of a packed engine into its caller's grid and hand it to the
+// observing callback. Called by every thread of the engine's parallel region.
+static void observe_packed(const uint64_t *packed, char *grid, int rows, int cols, int words,
+                           const EngineConfig *config, long long generation) {
+    #pragma omp for schedule(static)
+    for (int i = 0; i < rows; i++) {
+        unpack_row(packed + (size_t)i * words, grid + (size_t)i * cols, cols);
+    }
+    #pragma omp single
+    config->on_generation(grid, generation);
+}
+
+// Advance one packed row: carry-save adders turn the eight neighbour views into count bit planes,
+// which the rule network maps to the next state of 64 cells per word
+static inline void update_packed_row(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                                     int words, int cols, uint64_t last_mask, const RuleNetwork *network) {
+    for (int w = 0; w < words; w++) {
+        // Horizontal sums of three as 2-bit numbers (the middle row excludes the cell itself)
+        uint64_t uw = packed_west(up, w, words, cols), uc = up[w], ue = packed_east(up, w, words, cols);
+        uint64_t dw = packed_west(down, w, words, cols), dc = down[w], de = packed_east(down, w, words, cols);
+        uint64_t mw = packed_west(mid, w, words, cols), me = packed_east(mid, w, words, cols);
+
+        uint64_t u0 = uw ^ uc ^ ue, u1 = (uw & uc) | (ue & (uw ^ uc));
+        uint64_t d0 = dw ^ dc ^ de, d1 = (dw & dc) | (de & (dw ^ dc));
+        uint64_t m0 = mw ^ me, m1 = mw & me;
+
+        // Ones column, then the four weight-two bits, then the weight-four carries
+        uint64_t b0 = u0 ^ m0 ^ d0, k1 = (u0 & m0) | (d0 & (u0 ^ m0));
+        uint64_t t0 = u1 ^ m1 ^ d1, t1 = (u1 & m1) | (d1 & (u1 ^ m1));
+        uint64_t b1 = t0 ^ k1, t2 = t0 & k1;
+        uint64_t b2 = t1 ^ t2, b3 = t1 & t2;
+
+        out[w] = apply_rule_network(network, mid[w], b0, b1, b2, b3);
+    }
+    out[words - 1] &= last_mask;
+}
+
+// Bit-packed engine: 64 cells per word for any Life-like rule
+void engine_bitpack(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int words = (cols + 63) / 64;
+    int team = parallel_team_size(rows, cols, config->threads);
+    uint64_t last_mask = (cols & 63) == 0 ? ~0ULL : (1ULL << (cols & 63)) - 1;
+    uint64_t *packed = (uint64_t *)alloc_grid(rows, words * (int)sizeof(uint64_t));
+    uint64_t *scratch = (uint64_t *)alloc_grid(rows, words * (int)sizeof(uint64_t));
+    RuleNetwork network;
+
+    build_rule_network(&active_rule, &network);
+    pack_grid(grid, packed, rows, cols, words, team);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        uint64_t *current = packed;
+        uint64_t *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                const uint64_t *up = current + (size_t)(i == 0 ? rows - 1 : i - 1) * words;
+                const uint64_t *down = current + (size_t)(i == rows - 1 ? 0 : i + 1) * words;
+                update_packed_row(up, current + (size_t)i * words, down, next + (size_t)i * words,
+                                  words, cols, last_mask, &network);
+            }
+
+            uint64_t *tmp = current;
+            current = next;
+            next = tmp;
+            if (config->on_generation != NULL) {
+                observe_packed(current, grid, rows, cols, words, config, iter + 1);
+            }
+        }
+    }
+
+    unpack_grid(generations % 2 != 0 ? scratch : packed, grid, rows, cols, words, team);
+    free_grid((char *)scratch);
+    free_grid((char *)packed);
+}
+
+// Morton-tiled layout: the grid is cut into tile x tile tiles stored contiguously (row-major
+// inside a tile) and ordered along a Z-order curve of the tile coordinates, so cells that are
+// close in 2D are close in memory and vertical neighbours sit one short tile row apart
+typedef struct {
+    int tile;
+    int tiles_y, tiles_x;
+    int *slot;        // Tile (ty, tx) -> position in memory
+    int *coords;      // Position in memory -> ty * tiles_x + tx
+} MortonLayout;
+
+// Interleave the bits of y and x (y in the odd positions)
+static uint64_t morton_code(uint32_t y, uint32_t x) {
+    uint64_t code = 0;
+    for (int b = 0; b < 32; b++) {
+        code |= (uint64_t)((x >> b) & 1) << (2 * b);
+        code |= (uint64_t)((y >> b) & 1) << (2 * b + 1);
+    }
+    return code;
+}
+
+// Tile index with its Z-order code, sorted by code to lay the tiles out
+typedef struct {
+    uint64_t code;
+    int index;
+} MortonOrder;
+
+static int compare_morton(const void *a, const void *b) {
+    uint64_t x = ((const MortonOrder *)a)->code, y = ((const MortonOrder *)b)->code;
+    return (x > y) - (x < y);
+}
+
+// Order the tiles of a rows x cols grid along the Z curve
+static void morton_layout_init(MortonLayout *layout, int rows, int cols, int tile) {
+    int tiles = (rows / tile) * (cols / tile);
+    MortonOrder *order = malloc((size_t)tiles * sizeof(MortonOrder));
+
+    layout->tile = tile;
+    layout->tiles_y = rows / tile;
+    layout->tiles_x = cols / tile;
+    layout->slot = malloc((size_t)tiles * sizeof(int));
+    layout->coords = malloc((size_t)tiles * sizeof(int));
+    if (order == NULL || layout->slot == NULL || layout->coords == NULL) {
+        fprintf(stderr, "Failed to allocate the Morton layout\n");
+        exit(1);
+    }
+
+    for (int t = 0; t < tiles; t++) {
+        order[t].code = morton_code(t / layout->tiles_x, t % layout->tiles_x);
+        order[t].index = t;
+    }
+    qsort(order, tiles, sizeof(MortonOrder), compare_morton);
+    for (int s = 0; s < tiles; s++) {
+        int t = order[s].index;
+        layout->slot[t] = s;
+        layout->coords[s] = t;
+    }
+    free(order);
+}
+
+static void morton_layout_free(MortonLayout *layout) {
+    free(layout->slot);
+    free(layout->coords);
+}
+
+// First cell of tile (ty, tx), with torus wrap on the tile coordinates
+static inline char *morton_tile(const MortonLayout *layout, char *cells, int ty, int tx) {
+    ty = (ty + layout->tiles_y) % layout->tiles_y;
+    tx = (tx + layout->tiles_x) % layout->tiles_x;
+    return cells + (size_t)layout->slot[ty * layout->tiles_x + tx] * layout->tile * layout->tile;
+}
+
+// Convert between row-major and the tiled layout
+static void morton_from_row_major(const MortonLayout *layout, const char *grid, char *cells, int cols, int team) {
+    int tile = layout->tile;
+
+    #pragma omp parallel for schedule(static) num_threads(team) if(team > 1)
+    for (int t = 0; t < layout->tiles_y * layout->tiles_x; t++) {
+        int ty = t / layout->tiles_x, tx = t % layout->tiles_x;
+        char *dst = morton_tile(layout, cells, ty, tx);
+        for (int r = 0; r < tile; r++) {
+            memcpy(dst + r * tile, grid + (size_t)(ty * tile + r) * cols + (size_t)tx * tile, tile);
+        }
+    }
+}
+
+static void morton_to_row_major(const MortonLayout *layout, char *cells, char *grid, int cols, int team) {
+    int tile = layout->tile;
+
+    #pragma omp parallel for schedule(static) num_threads(team) if(team > 1)
+    for (int t = 0; t < layout->tiles_y * layout->tiles_x; t++) {
+        int ty = t / layout->tiles_x, tx = t % layout->tiles_x;
+        const char *src = morton_tile(layout, cells, ty, tx);
+        for (int r = 0; r < tile; r++) {
+            memcpy(grid + (size_t)(ty * tile + r) * cols + (size_t)tx * tile, src + r * tile, tile);
+        }
+    }
+}
+
+// Copy tile (ty, tx) and its one-cell ring from the eight neighbouring tiles into a
+// (tile + 2) x (tile + 2) halo buffer, so the kernel needs no wraparound
+static void morton_fill_halo(const MortonLayout *layout, char *cells, int ty, int tx, char *halo) {
+    int tile = layout->tile;
+    int stride = tile + 2;
+    const char *center = morton_tile(layout, cells, ty, tx);
+    const char *north = morton_tile(layout, cells, ty - 1, tx);
+    const char *south = morton_tile(layout, cells, ty + 1, tx);
+    const char *west = morton_tile(layout, cells, ty, tx - 1);
+    const char *east = morton_tile(layout, cells, ty, tx + 1);
+
+    memcpy(halo + 1, north + (tile - 1) * tile, tile);
+    memcpy(halo + (size_t)(tile + 1) * stride + 1, south, tile);
+    for (int r = 0; r < tile; r++) {
+        char *line = halo + (size_t)(r + 1) * stride;
+        line[0] = west[r * tile + tile - 1];
+        memcpy(line + 1, center + r * tile, tile);
+        line[tile + 1] = east[r * tile];
+    }
+
+    halo[0] = morton_tile(layout, cells, ty - 1, tx - 1)[tile * tile - 1];
+    halo[tile + 1] = morton_tile(layout, cells, ty - 1, tx + 1)[(tile - 1) * tile];
+    halo[(size_t)(tile + 1) * stride] = morton_tile(layout, cells, ty + 1, tx - 1)[tile - 1];
+    halo[(size_t)(tile + 1) * stride + tile + 1] = morton_tile(layout, cells, ty + 1, tx + 1)[0];
+}
+
+// Morton-tiled engine: walks the tiles in memory (Z) order and computes each from its halo buffer.
+// Grids whose sides are not multiples of the tile size run on the row-major blocked engine instead.
+void engine_morton(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int tile = config->tile > 0 ? config->tile : DEFAULT_TILE_SIZE;
+    if (rows % tile != 0 || cols % tile != 0) {
+        engine_parallel_blocked(grid, rows, cols, generations, config);
+        return;
+    }
+
+    MortonLayout layout;
+    int tiles = (rows / tile) * (cols / tile);
+    int stride = tile + 2;
+    int team = parallel_team_size(rows, cols, config->threads);
+    char *cells = alloc_grid(rows, cols);
+    char *scratch = alloc_grid(rows, cols);
+    char *halos = alloc_grid(team, stride * stride);
+    unsigned int birth = active_rule.birth;
+    unsigned int survive = active_rule.survive;
+
+    morton_layout_init(&layout, rows, cols, tile);
+    morton_from_row_major(&layout, grid, cells, cols, team);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *halo = halos + (size_t)omp_get_thread_num() * stride * stride;
+        char *current = cells;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int s = 0; s < tiles; s++) {
+                int t = layout.coords[s];
+                char *out = next + (size_t)s * tile * tile;
+
+                morton_fill_halo(&layout, current, t / layout.tiles_x, t % layout.tiles_x, halo);
+
+                for (int r = 0; r < tile; r++) {
+                    const char *up = halo + (size_t)r * stride + 1;
+                    const char *mid = up + stride;
+                    const char *down = mid + stride;
+                    char *line = out + r * tile;
+
+                    #pragma omp simd
+                    for (int j = 0; j < tile; j++) {
+                        unsigned int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                                                 mid[j - 1] + mid[j + 1] +
+                                                 down[j - 1] + down[j] + down[j + 1];
+                        line[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+                    }
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    morton_to_row_major(&layout, generations % 2 != 0 ? scratch : cells, grid, cols, team);
+    morton_layout_free(&layout);
+    free_grid(halos);
+    free_grid(scratch);
+    free_grid(cells);
+}
+
+// Start counting the hardware events of perf_events on every OpenMP thread.
+// Returns false when the counters are unavailable (no Linux perf, no PMU in a VM, or not permitted).
+bool perf_counters_begin() {
+#ifdef __linux__
+    int max_threads = omp_get_max_threads();
+    bool any = false;
+
+    free(perf_fds);
+    perf_fds = malloc((size_t)max_threads * PERF_EVENT_COUNT * sizeof(int));
+    if (perf_fds == NULL) {
+        return false;
+    }
+
+    // Counters follow a single thread, so each pool thread opens its own
+    #pragma omp parallel num_threads(max_threads) reduction(||:any)
+    {
+        int t = omp_get_thread_num();
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = perf_events[e].type;
+            attr.config = perf_events[e].config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            perf_fds[t * PERF_EVENT_COUNT + e] = fd;
+            any = any || fd >= 0;
+        }
+    }
+    return any;
+#else
+    return false;
+#endif
+}
+
+// Stop the counters and sum them over the threads; events that could not be counted report -1
+void perf_counters_end(long long counts[]) {
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        counts[e] = -1;
+    }
+#ifdef __linux__
+    if (perf_fds == NULL) {
+        return;
+    }
+
+    int max_threads = omp_get_max_threads();
+    #pragma omp parallel num_threads(max_threads)
+    {
+        int t = omp_get_thread_num();
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+            int fd = perf_fds[t * PERF_EVENT_COUNT + e];
+            long long value;
+            if (fd < 0) {
+                continue;
+            }
+            if (read(fd, &value, sizeof(value)) == (ssize_t)sizeof(value)) {
+                #pragma omp critical
+                counts[e] = counts[e] < 0 ? value : counts[e] + value;
+            }
+            close(fd);
+        }
+    }
+
+    free(perf_fds);
+    perf_fds = NULL;
+#endif
+}
+
+// Sleep while *word still holds value (or yield where futexes are unavailable)
+static void futex_wait(atomic_int *word, int value) {
+#ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+    if (atomic_load(word) == value) sched_yield();
+#endif
+}
+
+static void futex_wake_all(atomic_int *word) {
+#ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void barrier_init(SpinBarrier *barrier, int parties) {
+    atomic_init(&barrier->remaining, parties);
+    atomic_init(&barrier->sense, 0);
+    atomic_init(&barrier->sleepers, 0);
+    barrier->parties = parties;
+}
+
+// Wait until all parties arrive
+static void barrier_wait(SpinBarrier *barrier) {
+    int sense = !atomic_load(&barrier->sense);
+
+    if (atomic_fetch_sub(&barrier->remaining, 1) == 1) {
+        atomic_store(&barrier->remaining, barrier->parties);
+        atomic_store(&barrier->sense, sense);
+        // Sleepers register before their last check of the sense, so one of the two sides sees the other
+        if (atomic_load(&barrier->sleepers) > 0) {
+            futex_wake_all(&barrier->sense);
+        }
+        return;
+    }
+
+    for (int spin = 0; spin < BARRIER_SPINS; spin++) {
+        if (atomic_load_explicit(&barrier->sense, memory_order_acquire) == sense) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    atomic_fetch_add(&barrier->sleepers, 1);
+    while (atomic_load(&barrier->sense) != sense) {
+        futex_wait(&barrier->sense, !sense);
+    }
+    atomic_fetch_sub(&barrier->sleepers, 1);
+}
+
+// Worker loop: wait for a job, run it, report completion
+static void *pool_worker(void *arg) {
+    int member = (int)(intptr_t)arg;
+
+    for (;;) {
+        barrier_wait(&thread_pool.barrier);
+        if (thread_pool.quit) {
+            return NULL;
+        }
+        thread_pool.job(thread_pool.job_arg, member, thread_pool.size);
+        barrier_wait(&thread_pool.barrier);
+    }
+}
+
+// Stop and join the workers of the pool
+static void pool_shutdown() {
+    if (thread_pool.size == 0) {
+        return;
+    }
+    if (thread_pool.size > 1) {
+        thread_pool.quit = true;
+        barrier_wait(&thread_pool.barrier);
+        for (int t = 1; t < thread_pool.size; t++) {
+            pthread_join(thread_pool.threads[t], NULL);
+        }
+    }
+    free(thread_pool.threads);
+    thread_pool.threads = NULL;
+    thread_pool.size = 0;
+}
+
+// Run job on a team of the given size; the pool is created on first use and only rebuilt when
+// the team size changes, so repeated runs reuse the same threads
+static void pool_run(int team, void (*job)(void *arg, int member, int team), void *arg) {
+    if (team < 1) team = 1;
+    if (thread_pool.size != team) {
+        pool_shutdown();
+        thread_pool.threads = malloc((size_t)team * sizeof(pthread_t));
+        if (thread_pool.threads == NULL) {
+            fprintf(stderr, "Failed to allocate the thread pool\n");
+            exit(1);
+        }
+        thread_pool.size = team;
+        thread_pool.quit = false;
+        barrier_init(&thread_pool.barrier, team);
+        for (int t = 1; t < team; t++) {
+            if (pthread_create(&thread_pool.threads[t], NULL, pool_worker, (void *)(intptr_t)t) != 0) {
+                fprintf(stderr, "Failed to start pool thread %d\n", t);
+                exit(1);
+            }
+        }
+    }
+
+    if (team == 1) {
+        job(arg, 0, 1);
+        return;
+    }
+
+    thread_pool.job = job;
+    thread_pool.job_arg = arg;
+    barrier_wait(&thread_pool.barrier);
+    job(arg, 0, team);
+    barrier_wait(&thread_pool.barrier);
+}
+
+typedef struct {
+    char *grid;
+    char *scratch;
+    int rows, cols, generations;
+} PthreadsJob;
+
+// Each member owns one contiguous band of rows, the same split as schedule(static)
+static void pthreads_generations(void *arg, int member, int team) {
+    PthreadsJob *job = arg;
+    int rows = job->rows;
+    int begin = (int)((long long)rows * member / team);
+    int end = (int)((long long)rows * (member + 1) / team);
+    char *current = job->grid;
+    char *next = job->scratch;
+
+    for (int iter = 0; iter < job->generations; iter++) {
+        for (int i = begin; i < end; i++) {
+            update_row(current, next, rows, job->cols, i, 0, job->cols);
+        }
+        if (team > 1) {
+            barrier_wait(&thread_pool.barrier);
+        }
+
+        char *tmp = current;
+        current = next;
+        next = tmp;
+    }
+}
+
+// Row engine on the persistent pthread pool with the spin-then-futex barrier between generations
+void engine_pthreads(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    PthreadsJob job = {grid, scratch, rows, cols, generations};
+
+    pool_run(parallel_team_size(rows, cols, config->threads), pthreads_generations, &job);
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Owner side: take the most recently pushed tile, or -1 when the deque is empty
+static int deque_pop(TileDeque *deque) {
+    int b = atomic_load(&deque->bottom) - 1;
+    atomic_store(&deque->bottom, b);
+    int t = atomic_load(&deque->top);
+
+    if (t > b) {
+        atomic_store(&deque->bottom, t);
+        return -1;
+    }
+
+    int tile = deque->tiles[b];
+    if (t == b) {
+        // Last tile: race the thieves for it. A failed exchange overwrites t with the winner's
+        // top, so the empty deque is restored from the top read before the race.
+        int top = t;
+        if (!atomic_compare_exchange_strong(&deque->top, &t, top + 1)) {
+            tile = -1;
+        }
+        atomic_store(&deque->bottom, top + 1);
+    }
+    return tile;
+}
+
+// Thief side: take the oldest tile, or -1 when the deque is empty or another thread won it
+static int deque_steal(TileDeque *deque) {
+    int t = atomic_load(&deque->top);
+    int b = atomic_load(&deque->bottom);
+
+    if (t >= b) {
+        return -1;
+    }
+
+    int tile = deque->tiles[t];
+    if (!atomic_compare_exchange_strong(&deque->top, &t, t + 1)) {
+        return -1;
+    }
+    return tile;
+}
+
+// Whether a tile or one of its eight torus neighbours changed in the last generation
+static bool tile_is_active(const uint8_t *changed, int tiles_y, int tiles_x, int tile) {
+    int ty = tile / tiles_x, tx = tile % tiles_x;
+
+    for (int dy = -1; dy <= 1; dy++) {
+        int y = (ty + dy + tiles_y) % tiles_y;
+        for (int dx = -1; dx <= 1; dx++) {
+            if (changed[y * tiles_x + (tx + dx + tiles_x) % tiles_x]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Active-tile engine with work stealing. A tile is recomputed only when it or a neighbour changed
+// in the last generation; any other tile is unchanged, and so is its copy in the other buffer,
+// which was written two generations ago when the tile last had the same content. Each thread
+// pushes the active tiles of its own static range to its deque, works through them, and then
+// steals from random victims until every deque is empty.
+void engine_stealing(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int tile = config->tile > 0 ? config->tile : DEFAULT_TILE_SIZE;
+    int tiles_y = (rows + tile - 1) / tile;
+    int tiles_x = (cols + tile - 1) / tile;
+    int tiles = tiles_y * tiles_x;
+    int team = parallel_team_size(rows, cols, config->threads);
+    char *scratch = alloc_grid(rows, cols);
+    uint8_t *changed = malloc((size_t)tiles * 2);
+    int *slots = malloc((size_t)tiles * team * sizeof(int));
+    TileDeque *deques = malloc((size_t)team * sizeof(TileDeque));
+    long long computed = 0, stolen = 0;
+
+    if (changed == NULL || slots == NULL || deques == NULL) {
+        fprintf(stderr, "Failed to allocate the tile deques\n");
+        exit(1);
+    }
+
+    // Every tile counts as changed before the first generation
+    memset(changed, 1, (size_t)tiles);
+    for (int t = 0; t < team; t++) {
+        deques[t].tiles = slots + (size_t)t * tiles;
+        atomic_init(&deques[t].top, 0);
+        atomic_init(&deques[t].bottom, 0);
+    }
+
+    #pragma omp parallel num_threads(team) if(team > 1) reduction(+:computed, stolen)
+    {
+        int member = omp_get_thread_num();
+        int size = omp_get_num_threads();
+        int first = (int)((long long)tiles * member / size);
+        int last = (int)((long long)tiles * (member + 1) / size);
+        unsigned int seed = 2463534242u + 977u * member;
+        TileDeque *own = &deques[member];
+        char *current = grid;
+        char *next = scratch;
+        uint8_t *was_changed = changed;
+        uint8_t *now_changed = changed + tiles;
+
+        for (int iter = 0; iter < generations; iter++) {
+            // Fill: reset the deque with the active tiles of this thread's range
+            int count = 0;
+            for (int t = first; t < last; t++) {
+                now_changed[t] = 0;
+                if (tile_is_active(was_changed, tiles_y, tiles_x, t)) {
+                    own->tiles[count++] = t;
+                }
+            }
+            atomic_store(&own->top, 0);
+            atomic_store(&own->bottom, count);
+            #pragma omp barrier
+
+            // Compute: own tiles first, then steal; no tiles are added, so a full pass over
+            // empty deques means the generation's work is done
+            for (;;) {
+                int t = deque_pop(own);
+                for (int attempt = 0; t < 0 && attempt < size; attempt++) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 17;
+                    seed ^= seed << 5;
+                    int victim = (int)(seed % (unsigned int)size);
+                    for (int v = 0; v < size && t < 0; v++) {
+                        if ((victim + v) % size != member) {
+                            t = deque_steal(&deques[(victim + v) % size]);
+                        }
+                    }
+                    if (t >= 0) {
+                        stolen++;
+                    }
+                }
+                if (t < 0) {
+                    break;
+                }
+
+                int row_begin = (t / tiles_x) * tile;
+                int row_end = row_begin + tile < rows ? row_begin + tile : rows;
+                int col_begin = (t % tiles_x) * tile;
+                int col_end = col_begin + tile < cols ? col_begin + tile : cols;
+                bool differs = false;
+
+                for (int i = row_begin; i < row_end; i++) {
+                    size_t offset = (size_t)i * cols + col_begin;
+                    update_row(current, next, rows, cols, i, col_begin, col_end);
+                    differs = differs || memcmp(next + offset, current + offset, col_end - col_begin) != 0;
+                }
+                now_changed[t] = differs;
+                computed++;
+            }
+            #pragma omp barrier
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+            uint8_t *flags = was_changed;
+            was_changed = now_changed;
+            now_changed = flags;
+        }
+    }
+
+    stealing_tiles_computed = computed;
+    stealing_tiles_skipped = (long long)tiles * generations - computed;
+    stealing_tiles_stolen = stolen;
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free(deques);
+    free(slots);
+    free(changed);
+    free_grid(scratch);
+}
+
+// Ten cells of a packed row starting one column left of col, wrapping around the torus
+static inline uint64_t packed_window(const uint64_t *row, int col, int cols) {
+    int start = col - 1;
+
+    if (start >= 0 && start + MEMO_TILE + 2 <= cols) {
+        int w = start >> 6, b = start & 63;
+        uint64_t bits = row[w] >> b;
+        if (b > 64 - (MEMO_TILE + 2)) {
+            bits |= row[w + 1] << (64 - b);
+        }
+        return bits & 0x3FF;
+    }
+
+    uint64_t bits = 0;
+    for (int k = 0; k < MEMO_TILE + 2; k++) {
+        int j = (start + k + cols) % cols;
+        bits |= ((row[j >> 6] >> (j & 63)) & 1) << k;
+    }
+    return bits;
+}
+
+// Next state of the 8x8 interior of a 10x10 window, one byte per row
+static uint64_t memo_compute(const uint64_t window[MEMO_TILE + 2]) {
+    uint64_t next = 0;
+
+    for (int r = 1; r <= MEMO_TILE; r++) {
+        for (int c = 1; c <= MEMO_TILE; c++) {
+            int neighbors = __builtin_popcountll((window[r - 1] >> (c - 1)) & 7) +
+                            __builtin_popcountll((window[r] >> (c - 1)) & 5) +
+                            __builtin_popcountll((window[r + 1] >> (c - 1)) & 7);
+            uint16_t mask = ((window[r] >> c) & 1) ? active_rule.survive : active_rule.birth;
+            next |= (uint64_t)((mask >> neighbors) & 1) << ((r - 1) * 8 + c - 1);
+        }
+    }
+    return next;
+}
+
+// Memoizing engine on packed rows: every 8x8 tile is looked up by its 10x10 neighbourhood in a
+// per-thread direct-mapped table and only computed on a miss, so recurring still lifes and
+// oscillators in settled regions cost one lookup. Each thread takes whole bands of 8 rows, so no
+// two threads write the same output word. Grids whose sides are not multiples of 8 run on the
+// bitpack engine instead.
+void engine_memo(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    if (rows % MEMO_TILE != 0 || cols % MEMO_TILE != 0) {
+        engine_bitpack(grid, rows, cols, generations, config);
+        return;
+    }
+
+    int words = (cols + 63) / 64;
+    int bands = rows / MEMO_TILE;
+    int team = parallel_team_size(rows, cols, config->threads);
+    size_t entries = (size_t)1 << memo_table_bits;
+    uint64_t *packed = (uint64_t *)alloc_grid(rows, words * (int)sizeof(uint64_t));
+    uint64_t *scratch = (uint64_t *)alloc_grid(rows, words * (int)sizeof(uint64_t));
+    // Tables can exceed the int-sized grids of alloc_grid, so they are allocated by byte count
+    MemoEntry *tables = malloc((size_t)team * entries * sizeof(MemoEntry));
+    long long hits = 0, misses = 0;
+
+    if (tables == NULL) {
+        fprintf(stderr, "Failed to allocate %d memo tables of 2^%d entries\n", team, memo_table_bits);
+        exit(1);
+    }
+
+    // Entries depend on the rule, so tables never outlive a run
+    memset(tables, 0xFF, (size_t)team * entries * sizeof(MemoEntry));
+    pack_grid(grid, packed, rows, cols, words, team);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1) reduction(+:hits, misses)
+    {
+        MemoEntry *table = tables + (size_t)omp_get_thread_num() * entries;
+        uint64_t *current = packed;
+        uint64_t *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int band = 0; band < bands; band++) {
+                int top = band * MEMO_TILE;
+                const uint64_t *source[MEMO_TILE + 2];
+                uint64_t *out = next + (size_t)top * words;
+
+                for (int r = 0; r < MEMO_TILE + 2; r++) {
+                    source[r] = current + (size_t)((top + r - 1 + rows) % rows) * words;
+                }
+                memset(out, 0, (size_t)MEMO_TILE * words * sizeof(uint64_t));
+
+                for (int col = 0; col < cols; col += MEMO_TILE) {
+                    uint64_t window[MEMO_TILE + 2];
+                    uint64_t key_low = 0, key_high = 0;
+
+                    for (int r = 0; r < MEMO_TILE + 2; r++) {
+                        window[r] = packed_window(source[r], col, cols);
+                        if (r < 6) {
+                            key_low |= window[r] << (10 * r);
+                        } else {
+                            key_high |= window[r] << (10 * (r - 6));
+                        }
+                    }
+
+                    uint64_t hash = key_low * 0x9E3779B97F4A7C15ULL ^ key_high * 0xC2B2AE3D27D4EB4FULL;
+                    MemoEntry *entry = &table[hash >> (64 - memo_table_bits)];
+                    uint64_t result;
+
+                    if (entry->key_low == key_low && entry->key_high == key_high) {
+                        result = entry->next;
+                        hits++;
+                    } else {
+                        result = memo_compute(window);
+                        entry->key_low = key_low;
+                        entry->key_high = key_high;
+                        entry->next = result;
+                        misses++;
+                    }
+
+                    for (int r = 0; r < MEMO_TILE; r++) {
+                        out[(size_t)r * words + (col >> 6)] |= ((result >> (8 * r)) & 0xFF) << (col & 63);
+                    }
+                }
+            }
+
+            uint64_t *tmp = current;
+            current = next;
+            next = tmp;
+            if (config->on_generation != NULL) {
+                observe_packed(current, grid, rows, cols, words, config, iter + 1);
+            }
+        }
+    }
+
+    memo_hits = hits;
+    memo_misses = misses;
+    memo_table_bytes = (size_t)team * entries * sizeof(MemoEntry);
+
+    unpack_grid(generations % 2 != 0 ? scratch : packed, grid, rows, cols, words, team);
+    free(tables);
+    free_grid((char *)scratch);
+    free_grid((char *)packed);
+}
+
+// Row kernel for a power-of-two width: the edge columns wrap with a mask and the interior strip
+// has a constant trip count once inlined into a specialization, so the compiler can unroll and
+// vectorize it completely
+static inline __attribute__((always_inline)) void update_row_pow2(const char *grid, char *next_grid, int rows,
+                                                                  int cols, int row) {
+    const char *up = grid + (size_t)(row == 0 ? rows - 1 : row - 1) * cols;
+    const char *mid = grid + (size_t)row * cols;
+    const char *down = grid + (size_t)(row == rows - 1 ? 0 : row + 1) * cols;
+    char *out = next_grid + (size_t)row * cols;
+    unsigned int birth = active_rule.birth;
+    unsigned int survive = active_rule.survive;
+    int mask = cols - 1;
+
+    for (int j = 0; j < cols; j += cols - 1) {
+        int left = (j - 1) & mask;
+        int right = (j + 1) & mask;
+        unsigned int neighbors = up[left] + up[j] + up[right] +
+                                 mid[left] + mid[right] +
+                                 down[left] + down[j] + down[right];
+        out[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+    }
+
+    #pragma omp simd
+    for (int j = 1; j < cols - 1; j++) {
+        unsigned int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                                 mid[j - 1] + mid[j + 1] +
+                                 down[j - 1] + down[j] + down[j + 1];
+        out[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+    }
+}
+
+typedef void (*row_kernel)(const char *grid, char *next_grid, int rows, int cols, int row);
+
+// One specialization per width, with cols folded to a constant
+#define DEFINE_POW2_KERNEL(COLS)                                                                   \
+    static void update_row_pow2_##COLS(const char *grid, char *next_grid, int rows, int cols, int row) { \
+        (void)cols;                                                                                \
+        update_row_pow2(grid, next_grid, rows, COLS, row);                                         \
+    }
+
+DEFINE_POW2_KERNEL(64)
+DEFINE_POW2_KERNEL(128)
+DEFINE_POW2_KERNEL(256)
+DEFINE_POW2_KERNEL(512)
+DEFINE_POW2_KERNEL(1024)
+DEFINE_POW2_KERNEL(2048)
+DEFINE_POW2_KERNEL(4096)
+DEFINE_POW2_KERNEL(8192)
+
+static const struct {
+    int cols;
+    row_kernel kernel;
+} pow2_kernels[] = {
+    {64, update_row_pow2_64},
+    {128, update_row_pow2_128},
+    {256, update_row_pow2_256},
+    {512, update_row_pow2_512},
+    {1024, update_row_pow2_1024},
+    {2048, update_row_pow2_2048},
+    {4096, update_row_pow2_4096},
+    {8192, update_row_pow2_8192},
+};
+#define POW2_KERNEL_COUNT ((int)(sizeof(pow2_kernels) / sizeof(pow2_kernels[0])))
+
+// Generic fallback with the runtime width
+static void update_row_generic(const char *grid, char *next_grid, int rows, int cols, int row) {
+    update_row_strip(grid, next_grid, rows, cols, row, 0, cols);
+}
+
+// Runtime dispatch: the specialized kernel for this width, or the generic one
+row_kernel select_row_kernel(int cols) {
+    for (int k = 0; k < POW2_KERNEL_COUNT; k++) {
+        if (pow2_kernels[k].cols == cols) {
+            return pow2_kernels[k].kernel;
+        }
+    }
+    return update_row_generic;
+}
+
+// Parallel engine over rows using the kernel specialized for the grid width when there is one
+void engine_pow2(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+    row_kernel kernel = select_row_kernel(cols);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                kernel(current, next, rows, cols, i);
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Halo fills. The interior rows' side columns are filled first, then the top and bottom rows
+// including the corners, so corners follow the same rule as the edge they extend.
+void fill_halo_torus(char *padded, int rows, int cols) {
+    size_t stride = (size_t)cols + 2;
+
+    for (int i = 1; i <= rows; i++) {
+        char *line = padded + i * stride;
+        line[0] = line[cols];
+        line[cols + 1] = line[1];
+    }
+    memcpy(padded, padded + rows * stride, stride);
+    memcpy(padded + (rows + 1) * stride, padded + stride, stride);
+}
+
+void fill_halo_dead(char *padded, int rows, int cols) {
+    size_t stride = (size_t)cols + 2;
+
+    for (int i = 1; i <= rows; i++) {
+        padded[i * stride] = CELL_DEAD;
+        padded[i * stride + cols + 1] = CELL_DEAD;
+    }
+    memset(padded, CELL_DEAD, stride);
+    memset(padded + (rows + 1) * stride, CELL_DEAD, stride);
+}
+
+// Mirror at the edge: the cell beyond an edge copies the edge cell
+void fill_halo_reflect(char *padded, int rows, int cols) {
+    size_t stride = (size_t)cols + 2;
+
+    for (int i = 1; i <= rows; i++) {
+        char *line = padded + i * stride;
+        line[0] = line[1];
+        line[cols + 1] = line[cols];
+    }
+    memcpy(padded, padded + stride, stride);
+    memcpy(padded + (rows + 1) * stride, padded + rows * stride, stride);
+}
+
+// Klein bottle: columns wrap as on the torus, rows wrap with the row mirrored left to right
+void fill_halo_klein(char *padded, int rows, int cols) {
+    size_t stride = (size_t)cols + 2;
+    char *top = padded;
+    char *bottom = padded + (rows + 1) * stride;
+    const char *first = padded + stride + 1;
+    const char *last = padded + rows * stride + 1;
+
+    for (int i = 1; i <= rows; i++) {
+        char *line = padded + i * stride;
+        line[0] = line[cols];
+        line[cols + 1] = line[1];
+    }
+    for (int j = -1; j <= cols; j++) {
+        int mirrored = ((cols - 1 - j) % cols + cols) % cols;
+        top[j + 1] = last[mirrored];
+        bottom[j + 1] = first[mirrored];
+    }
+}
+
+const Boundary *find_boundary(const char *name) {
+    for (int i = 0; i < BOUNDARY_COUNT; i++) {
+        if (strcmp(boundaries[i].name, name) == 0) {
+            return &boundaries[i];
+        }
+    }
+    return NULL;
+}
+
+// Engine whose results the others are checked against: serial on the torus, halo for other
+// boundaries, the lookup-table engine for Generations rules, the naive box count for
+// Larger-than-Life rules
+const Engine *reference_engine() {
+    if (active_ltl.radius > 0) {
+        return find_engine("ltlref");
+    }
+    if (active_rule.states > 2) {
+        return find_engine("genref");
+    }
+    return find_engine(active_boundary->fill == fill_halo_torus ? "serial" : "halo");
+}
+
+// Padded-grid engine: each generation one thread fills the halo with the active boundary, then
+// the rows run one shared kernel that never wraps, so every boundary costs the same per cell
+void engine_halo(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    size_t stride = (size_t)cols + 2;
+    char *padded = alloc_grid(rows + 2, cols + 2);
+    char *scratch = alloc_grid(rows + 2, cols + 2);
+    int team = parallel_team_size(rows, cols, config->threads);
+    halo_fill fill = active_boundary->fill;
+    unsigned int birth = active_rule.birth;
+    unsigned int survive = active_rule.survive;
+
+    for (int i = 0; i < rows; i++) {
+        memcpy(padded + (i + 1) * stride + 1, grid + (size_t)i * cols, cols);
+    }
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = padded;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp single
+            fill(current, rows, cols);
+
+            #pragma omp for schedule(runtime)
+            for (int i = 1; i <= rows; i++) {
+                const char *up = current + (i - 1) * stride + 1;
+                const char *mid = up + stride;
+                const char *down = mid + stride;
+                char *out = next + i * stride + 1;
+
+                #pragma omp simd
+                for (int j = 0; j < cols; j++) {
+                    unsigned int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                                             mid[j - 1] + mid[j + 1] +
+                                             down[j - 1] + down[j] + down[j + 1];
+                    out[j] = ((mid[j] ? survive : birth) >> neighbors) & 1;
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    const char *result = generations % 2 != 0 ? scratch : padded;
+    for (int i = 0; i < rows; i++) {
+        memcpy(grid + (size_t)i * cols, result + (i + 1) * stride + 1, cols);
+    }
+    free_grid(scratch);
+    free_grid(padded);
+}
+
+// Bit planes needed to store the states of a Generations rule
+static int state_planes(int states) {
+    int planes = 1;
+    while ((1 << planes) < states) {
+        planes++;
+    }
+    return planes;
+}
+
+// Next state of every (state, live neighbour count) pair of the active rule
+static void build_generations_table(uint8_t table[MAX_RULE_STATES][9]) {
+    int states = active_rule.states;
+
+    for (int state = 0; state < states; state++) {
+        for (int n = 0; n <= 8; n++) {
+            if (state == 0) {
+                table[state][n] = (active_rule.birth >> n) & 1;
+            } else if (state == 1 && ((active_rule.survive >> n) & 1)) {
+                table[state][n] = 1;
+            } else {
+                table[state][n] = (state + 1) % states;
+            }
+        }
+    }
+}
+
+// Reference engine for Generations rules: counts live (state 1) neighbours of byte cells and
+// looks the next state up in a (state, count) table
+void engine_generations_reference(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    uint8_t table[MAX_RULE_STATES][9];
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+
+    build_generations_table(table);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                const char *up = current + (size_t)(i == 0 ? rows - 1 : i - 1) * cols;
+                const char *mid = current + (size_t)i * cols;
+                const char *down = current + (size_t)(i == rows - 1 ? 0 : i + 1) * cols;
+                char *out = next + (size_t)i * cols;
+
+                for (int j = 0; j < cols; j++) {
+                    int left = (j == 0) ? cols - 1 : j - 1;
+                    int right = (j == cols - 1) ? 0 : j + 1;
+                    int neighbors = (up[left] == CELL_LIVE) + (up[j] == CELL_LIVE) + (up[right] == CELL_LIVE) +
+                                    (mid[left] == CELL_LIVE) + (mid[right] == CELL_LIVE) +
+                                    (down[left] == CELL_LIVE) + (down[j] == CELL_LIVE) + (down[right] == CELL_LIVE);
+                    out[j] = table[(int)mid[j]][neighbors];
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Split byte states into bit planes of packed rows (plane k holds bit k of every state) and back
+static void pack_state_planes(const char *grid, uint64_t *planes, int rows, int cols, int words, int count, int team) {
+    #pragma omp parallel for schedule(static) num_threads(team) if(team > 1)
+    for (int i = 0; i < rows; i++) {
+        for (int k = 0; k < count; k++) {
+            uint64_t *row = planes + ((size_t)k * rows + i) * words;
+            memset(row, 0, (size_t)words * sizeof(uint64_t));
+            for (int j = 0; j < cols; j++) {
+                row[j >> 6] |= (uint64_t)((grid[(size_t)i * cols + j] >> k) & 1) << (j & 63);
+            }
+        }
+    }
+}
+
+static void unpack_state_planes(const uint64_t *planes, char *grid, int rows, int cols, int words, int count, int team) {
+    #pragma omp parallel for schedule(static) num_threads(team) if(team > 1)
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            int state = 0;
+            for (int k = 0; k < count; k++) {
+                state |= (int)((planes[((size_t)k * rows + i) * words + (j >> 6)] >> (j & 63)) & 1) << k;
+            }
+            grid[(size_t)i * cols + j] = state;
+        }
+    }
+}
+
+// Bit-plane Generations engine: states live in 1-4 packed planes. Each generation first derives
+// a packed plane of live (state 1) cells, then runs the bitpack carry-save counter and rule
+// network on it; cells that neither are born nor survive advance by a bit-sliced increment
+// that wraps to dead at the state count.
+void engine_generations(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int words = (cols + 63) / 64;
+    int states = active_rule.states;
+    int count = state_planes(states);
+    int team = parallel_team_size(rows, cols, config->threads);
+    uint64_t last_mask = (cols & 63) == 0 ? ~0ULL : (1ULL << (cols & 63)) - 1;
+    uint64_t *packed = (uint64_t *)alloc_grid(rows * count, words * (int)sizeof(uint64_t));
+    uint64_t *scratch = (uint64_t *)alloc_grid(rows * count, words * (int)sizeof(uint64_t));
+    uint64_t *live = (uint64_t *)alloc_grid(rows, words * (int)sizeof(uint64_t));
+    size_t plane = (size_t)rows * words;
+    RuleNetwork network;
+
+    build_rule_network(&active_rule, &network);
+    pack_state_planes(grid, packed, rows, cols, words, count, team);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        uint64_t *current = packed;
+        uint64_t *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            // Live cells are the ones whose state is exactly 1
+            #pragma omp for schedule(static)
+            for (size_t w = 0; w < plane; w++) {
+                uint64_t one = current[w];
+                for (int k = 1; k < count; k++) {
+                    one &= ~current[k * plane + w];
+                }
+                live[w] = one;
+            }
+
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                const uint64_t *up = live + (size_t)(i == 0 ? rows - 1 : i - 1) * words;
+                const uint64_t *mid = live + (size_t)i * words;
+                const uint64_t *down = live + (size_t)(i == rows - 1 ? 0 : i + 1) * words;
+                uint64_t *alive_next = next + (size_t)i * words;
+
+                // Plane 0 of next receives the cells that are live in the next generation
+                update_packed_row(up, mid, down, alive_next, words, cols, last_mask, &network);
+
+                for (int w = 0; w < words; w++) {
+                    size_t at = (size_t)i * words + w;
+                    uint64_t nonzero = 0, carry = ~0ULL, wrap = ~0ULL;
+                    uint64_t sum[4];
+
+                    for (int k = 0; k < count; k++) {
+                        uint64_t bit = current[k * plane + at];
+                        nonzero |= bit;
+                        sum[k] = bit ^ carry;
+                        carry &= bit;
+                        wrap &= (states >> k) & 1 ? sum[k] : ~sum[k];
+                    }
+                    if (states == 1 << count) {
+                        wrap = carry;
+                    }
+
+                    uint64_t lives = alive_next[w];
+                    uint64_t advance = nonzero & ~(mid[w] & lives) & ~wrap;
+                    uint64_t settled = ~(nonzero & ~(mid[w] & lives));
+
+                    for (int k = 0; k < count; k++) {
+                        next[k * plane + at] = ((advance & sum[k]) | (k == 0 ? settled & lives : 0)) &
+                                               (w == words - 1 ? last_mask : ~0ULL);
+                    }
+                }
+            }
+
+            uint64_t *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    unpack_state_planes(generations % 2 != 0 ? scratch : packed, grid, rows, cols, words, count, team);
+    free_grid((char *)live);
+    free_grid((char *)scratch);
+    free_grid((char *)packed);
+}
+
+// Parse a Larger-than-Life rule in R,C,M,S,B notation, e.g. R5,C0,M1,S34..58,B34..45[,NM].
+// Only two-state rules (C0 or C2) on the Moore neighbourhood are supported.
+bool parse_ltl_rule(const char *text, LtlRule *rule) {
+    LtlRule parsed = {0, false, 0, -1, 0, -1};
+    char copy[128];
+    bool seen_survive = false, seen_birth = false;
+
+    snprintf(copy, sizeof(copy), "%s", text);
+    for (char *token = strtok(copy, ","); token != NULL; token = strtok(NULL, ",")) {
+        int low, high, value;
+        char kind = token[0] >= 'a' ? token[0] - 'a' + 'A' : token[0];
+
+        if (kind == 'N' && (strcmp(token + 1, "M") == 0 || strcmp(token + 1, "m") == 0)) {
+            continue;
+        } else if ((kind == 'S' || kind == 'B') && sscanf(token + 1, "%d..%d", &low, &high) == 2) {
+            if (kind == 'S') {
+                parsed.survive_min = low;
+                parsed.survive_max = high;
+                seen_survive = true;
+            } else {
+                parsed.birth_min = low;
+                parsed.birth_max = high;
+                seen_birth = true;
+            }
+        } else if (sscanf(token + 1, "%d", &value) == 1 && (kind == 'R' || kind == 'C' || kind == 'M')) {
+            if (kind == 'R') {
+                parsed.radius = value;
+            } else if (kind == 'C' && value != 0 && value != 2) {
+                return false;
+            } else if (kind == 'M') {
+                parsed.middle = value != 0;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    if (parsed.radius < 1 || parsed.radius > 500 || !seen_survive || !seen_birth) {
+        return false;
+    }
+    *rule = parsed;
+    return true;
+}
+
+// Text of the rule the workload engines run
+void format_active_rule(char *text, size_t len) {
+    if (active_ltl.radius > 0) {
+        snprintf(text, len, "R%d,C0,M%d,S%d..%d,B%d..%d", active_ltl.radius, active_ltl.middle ? 1 : 0,
+                 active_ltl.survive_min, active_ltl.survive_max, active_ltl.birth_min, active_ltl.birth_max);
+    } else {
+        format_rule(&active_rule, text, len);
+    }
+}
+
+// Engine used for the active rule and boundary when neither the command line nor a profile picks one
+const Engine *default_engine() {
+    return find_engine(active_ltl.radius > 0 ? "ltl" :
+                       active_rule.states > 2 ? "generations" :
+                       active_boundary->fill == fill_halo_torus ? "rows" : "halo");
+}
+
+// Whether an engine can run the active rule and boundary
+bool engine_supports_workload(const Engine *engine) {
+    if (active_boundary->fill != fill_halo_torus && !engine->bounded) {
+        return false;
+    }
+    if (active_rule.states > 2 && !engine->multistate) {
+        return false;
+    }
+    return (active_ltl.radius > 0) == engine->ranged;
+}
+
+// Next state of a cell from its box count under the active Larger-than-Life rule
+static inline char ltl_next(char cell, int count) {
+    if (!active_ltl.middle) {
+        count -= cell;
+    }
+    if (cell == CELL_LIVE) {
+        return count >= active_ltl.survive_min && count <= active_ltl.survive_max;
+    }
+    return count >= active_ltl.birth_min && count <= active_ltl.birth_max;
+}
+
+// Naive Larger-than-Life reference: counts every cell's box directly, O(R^2) per cell
+void engine_ltl_reference(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int radius = active_ltl.radius;
+    char *scratch = alloc_grid(rows, cols);
+    int team = parallel_team_size(rows, cols, config->threads);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    int count = 0;
+                    for (int dy = -radius; dy <= radius; dy++) {
+                        const char *row = current + (size_t)((((i + dy) % rows) + rows) % rows) * cols;
+                        for (int dx = -radius; dx <= radius; dx++) {
+                            count += row[(((j + dx) % cols) + cols) % cols];
+                        }
+                    }
+                    next[(size_t)i * cols + j] = ltl_next(current[(size_t)i * cols + j], count);
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid(scratch);
+}
+
+// Larger-than-Life engine on a summed-area table. Each generation builds the 2D prefix sums of
+// the grid extended by R cells of torus wrap on every side (rows in parallel, then column blocks
+// in parallel), so every box count is four lookups whatever the radius. Sums are unsigned 32-bit:
+// they may wrap on huge grids, but the differences that form a box count stay exact.
+void engine_ltl(char *grid, int rows, int cols, int generations, const EngineConfig *config) {
+    int radius = active_ltl.radius;
+    int box = 2 * radius + 1;
+    int sat_rows = rows + box;
+    int sat_cols = cols + box;
+    char *scratch = alloc_grid(rows, cols);
+    uint32_t *sat = (uint32_t *)alloc_grid(sat_rows, sat_cols * (int)sizeof(uint32_t));
+    int team = parallel_team_size(rows, cols, config->threads);
+    omp_set_schedule(config->schedule, config->chunk);
+
+    // Row 0 and column 0 of the table are the empty prefix
+    memset(sat, 0, (size_t)sat_cols * sizeof(uint32_t));
+
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        char *current = grid;
+        char *next = scratch;
+
+        for (int iter = 0; iter < generations; iter++) {
+            // Horizontal prefix sums of the extended rows
+            #pragma omp for schedule(static)
+            for (int y = 1; y < sat_rows; y++) {
+                const char *row = current + (size_t)((((y - 1 - radius) % rows) + rows) % rows) * cols;
+                uint32_t *out = sat + (size_t)y * sat_cols;
+                uint32_t sum = 0;
+                int x = (((-radius) % cols) + cols) % cols;
+
+                out[0] = 0;
+                for (int k = 1; k < sat_cols; k++) {
+                    sum += row[x];
+                    out[k] = sum;
+                    if (++x == cols) x = 0;
+                }
+            }
+
+            // Vertical prefix sums, one block of columns per iteration so rows stream through cache
+            #pragma omp for schedule(static)
+            for (int block = 0; block < (sat_cols + 255) / 256; block++) {
+                int begin = block * 256;
+                int end = begin + 256 < sat_cols ? begin + 256 : sat_cols;
+                for (int y = 2; y < sat_rows; y++) {
+                    uint32_t *out = sat + (size_t)y * sat_cols;
+                    const uint32_t *above = out - sat_cols;
+                    #pragma omp simd
+                    for (int x = begin; x < end; x++) {
+                        out[x] += above[x];
+                    }
+                }
+            }
+
+            // Box count of cell (i, j) spans table rows i..i+box and columns j..j+box
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < rows; i++) {
+                const uint32_t *top = sat + (size_t)i * sat_cols;
+                const uint32_t *bottom = sat + (size_t)(i + box) * sat_cols;
+                const char *mid = current + (size_t)i * cols;
+                char *out = next + (size_t)i * cols;
+
+                for (int j = 0; j < cols; j++) {
+                    int count = (int)(bottom[j + box] - top[j + box] - bottom[j] + top[j]);
+                    out[j] = ltl_next(mid[j], count);
+                }
+            }
+
+            char *tmp = current;
+            current = next;
+            next = tmp;
+        }
+    }
+
+    if (generations % 2 != 0) {
+        memcpy(grid, scratch, (size_t)rows * cols);
+    }
+    free_grid((char *)sat);
+    free_grid(scratch);
+}
+
+// Number of work items an engine distributes per generation (rows, row bands or 2D blocks)
+int engine_work_items(const Engine *engine, int rows, int cols, const EngineConfig *config) {
+    int tile = config->tile > 0 ? config->tile : DEFAULT_TILE_SIZE;
+
+    if (engine->blocks) {
+        return ((rows + tile - 1) / tile) * ((cols + tile - 1) / tile);
+    }
+    if (engine->tiled) {
+        return (rows + tile - 1) / tile;
+    }
+    return rows;
+}
+
+// Look up an engine by name
+const Engine *find_engine(const char *name) {
+    for (int i = 0; i < ENGINE_COUNT; i++) {
+        if (strcmp(engines[i].name, name) == 0) {
+            return &engines[i];
+        }
+    }
+    return NULL;
+}
+
+// Name of an OpenMP schedule kind
+const char *schedule_name(omp_sched_t schedule) {
+    for (int i = 0; i < SCHEDULE_KIND_COUNT; i++) {
+        if (schedule_kinds[i].kind == schedule) {
+            return schedule_kinds[i].name;
+        }
+    }
+    return "unknown";
+}
+
+// Parse an OpenMP schedule kind
+bool parse_schedule(const char *name, omp_sched_t *schedule) {
+    for (int i = 0; i < SCHEDULE_KIND_COUNT; i++) {
+        if (strcmp(name, schedule_kinds[i].name) == 0) {
+            *schedule = schedule_kinds[i].kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Configuration used when neither the command line nor a profile decides
+void default_engine_config(EngineConfig *config) {
+    config->threads = omp_get_max_threads();
+    config->schedule = omp_sched_static;
+    config->chunk = 0;
+    config->tile = DEFAULT_TILE_SIZE;
+    config->prefetch = DEFAULT_PREFETCH_ROWS;
+    config->on_generation = NULL;
+}
+
+// Run an engine on a copy of the initial grid and return the best wall time of TUNE_REPETITIONS runs
+double time_engine(const Engine *engine, const char *initial, char *work, int rows, int cols,
+                   int generations, const EngineConfig *config) {
+    double best = 0;
+
+    for (int rep = 0; rep < TUNE_REPETITIONS; rep++) {
+        memcpy(work, initial, (size_t)rows * cols);
+
+        double start_time = omp_get_wtime();
+        engine->run(work, rows, cols, generations, config);
+        double time_taken = omp_get_wtime() - start_time;
+
+        if (rep == 0 || time_taken < best) {
+            best = time_taken;
+        }
+    }
+
+    return best;
+}
+
+// Time one candidate configuration, rejecting it if its result differs from the reference
+static bool probe_candidate(const Engine *engine, const EngineConfig *config, const char *initial,
+                            const char *reference, char *work, const Workload *workload, int generations,
+                            const Engine **best_engine, EngineConfig *best_config, double *best_time) {
+    double time_taken = time_engine(engine, initial, work, workload->rows, workload->cols, generations, config);
+
+    if (memcmp(work, reference, (size_t)workload->rows * workload->cols) != 0) {
+        printf("  %-8s threads=%-3d %s,%-5d tile=%-4d prefetch=%-2d  INCONSISTENT, rejected\n", engine->name,
+               config->threads, schedule_name(config->schedule), config->chunk, config->tile, config->prefetch);
+        return false;
+    }
+
+    printf("  %-8s threads=%-3d %s,%-5d tile=%-4d prefetch=%-2d  %.6f s\n", engine->name, config->threads,
+           schedule_name(config->schedule), config->chunk, config->tile, config->prefetch, time_taken);
+
+    if (*best_engine == NULL || time_taken < *best_time) {
+        *best_engine = engine;
+        *best_config = *config;
+        *best_time = time_taken;
+        return true;
+    }
+    return false;
+}
+
+// Thread counts probed by the tuner: powers of two, then the maximum
+static int next_thread_count(int threads, int max_threads) {
+    if (threads >= max_threads) {
+        return max_threads + 1;
+    }
+    return threads * 2 < max_threads ? threads * 2 : max_threads;
+}
+
+// Probe engines, thread counts, schedules, chunk sizes and tile sizes on the workload and return the fastest.
+// The search is staged: engine and threads first, then schedule and chunk, then tile size, then
+// the prefetch distance of streaming engines.
+const Engine *tune_workload(const Workload *workload, EngineConfig *best_config, double *best_time) {
+    int rows = workload->rows;
+    int cols = workload->cols;
+    int max_threads = omp_get_max_threads();
+    char *initial = alloc_grid(rows, cols);
+    char *reference = alloc_grid(rows, cols);
+    char *work = alloc_grid(rows, cols);
+    const Engine *best_engine = NULL;
+    EngineConfig config;
+
+    initialize_workload_grid(initial, workload);
+    default_engine_config(&config);
+
+    // Size the probes from the cost of one serial generation
+    const Engine *reference_run = reference_engine();
+    config.threads = 1;
+    memcpy(reference, initial, (size_t)rows * cols);
+    double start_time = omp_get_wtime();
+    reference_run->run(reference, rows, cols, 1, &config);
+    double generation_time = omp_get_wtime() - start_time;
+
+    int probe_generations = generation_time > 0 ? (int)(TUNE_PROBE_SECONDS / generation_time) : workload->generations;
+    if (probe_generations < 1) probe_generations = 1;
+    if (probe_generations > workload->generations) probe_generations = workload->generations;
+
+    memcpy(reference, initial, (size_t)rows * cols);
+    reference_run->run(reference, rows, cols, probe_generations, &config);
+
+    printf("Tuning %dx%d grid (density %.3f) with %d probe generations\n", rows, cols,
+           (double)count_live(initial, rows, cols) / ((double)rows * cols), probe_generations);
+
+    // Stage 1: engine and thread count with the default schedule
+    printf("Stage 1: engines and thread counts\n");
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        if (!engine_supports_workload(&engines[e])) {
+            continue;
+        }
+        for (int threads = 1; threads <= max_threads; threads = next_thread_count(threads, max_threads)) {
+            default_engine_config(&config);
+            config.threads = threads;
+            probe_candidate(&engines[e], &config, initial, reference, work, workload, probe_generations,
+                            &best_engine, best_config, best_time);
+            if (!engines[e].parallel) {
+                break;
+            }
+        }
+    }
+
+    // Stage 2: schedule kind and chunk size, from single iterations up to one band per thread
+    if (best_engine != NULL && best_engine->scheduled) {
+        static const omp_sched_t kinds[] = {omp_sched_static, (omp_sched_t)(omp_sched_dynamic | omp_sched_monotonic),
+                                            omp_sched_guided};
+        int items = engine_work_items(best_engine, rows, cols, best_config);
+        int band = (items + best_config->threads - 1) / best_config->threads;
+        const Engine *engine = best_engine;
+        EngineConfig base = *best_config;
+
+        printf("Stage 2: schedules and chunk sizes\n");
+        for (int k = 0; k < (int)(sizeof(kinds) / sizeof(kinds[0])); k++) {
+            for (int chunk = 1; chunk <= band; chunk = chunk < band && chunk * 4 > band ? band : chunk * 4) {
+                config = base;
+                config.schedule = kinds[k];
+                config.chunk = chunk;
+                probe_candidate(engine, &config, initial, reference, work, workload, probe_generations,
+                                &best_engine, best_config, best_time);
+            }
+        }
+    }
+
+    // Stage 3: tile size
+    if (best_engine != NULL && best_engine->tiled) {
+        const Engine *engine = best_engine;
+        EngineConfig base = *best_config;
+        int limit = rows > cols ? rows : cols;
+
+        printf("Stage 3: tile sizes\n");
+        for (int tile = 16; tile <= 256 && tile <= limit; tile *= 2) {
+            if (tile == base.tile) {
+                continue;
+            }
+            config = base;
+            config.tile = tile;
+            probe_candidate(engine, &config, initial, reference, work, workload, probe_generations,
+                            &best_engine, best_config, best_time);
+        }
+    }
+
+    // Stage 4: prefetch distance of the streaming path
+    if (best_engine != NULL && best_engine->streams && grid_streams(rows, cols)) {
+        static const int distances[] = {0, 1, 2, 4, 8, 16};
+        const Engine *engine = best_engine;
+        EngineConfig base = *best_config;
+
+        printf("Stage 4: prefetch distances\n");
+        for (int d = 0; d < (int)(sizeof(distances) / sizeof(distances[0])); d++) {
+            if (distances[d] == base.prefetch) {
+                continue;
+            }
+            config = base;
+            config.prefetch = distances[d];
+            probe_candidate(engine, &config, initial, reference, work, workload, probe_generations,
+                            &best_engine, best_config, best_time);
+        }
+    }
+
+    *best_time /= probe_generations;
+
+    free_grid(work);
+    free_grid(reference);
+    free_grid(initial);
+    return best_engine;
+}
+
+// Profile key of a workload: host name, grid size, initial density bucket and rule, followed by a space
+void workload_key(const Workload *workload, char *key, size_t len) {
+    char host[256], rule[32];
+
+    if (gethostname(host, sizeof(host)) != 0) {
+        snprintf(host, sizeof(host), "unknown");
+    }
+    host[sizeof(host) - 1] = '\0';
+    format_active_rule(rule, sizeof(rule));
+
+    // Bucket the measured initial density so nearby workloads share a decision
+    char *grid = alloc_grid(workload->rows, workload->cols);
+    initialize_workload_grid(grid, workload);
+    double live = (double)count_live(grid, workload->rows, workload->cols) / ((double)workload->rows * workload->cols);
+    free_grid(grid);
+
+    // Other boundaries than the torus are part of the rule token
+    snprintf(key, len, "%s %d %d %.2f %s%s%s ", host, workload->rows, workload->cols, (int)(live * 20 + 0.5) / 20.0,
+             rule, active_boundary->fill == fill_halo_torus ? "" : ",",
+             active_boundary->fill == fill_halo_torus ? "" : active_boundary->name);
+}
+
+// Look up the tuned configuration of a workload; returns NULL when the profile has none
+const Engine *load_tuning_profile(const char *path, const Workload *workload, EngineConfig *config) {
+    char key[320], line[512];
+    const Engine *engine = NULL;
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    workload_key(workload, key, sizeof(key));
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char entry_engine[64], entry_schedule[32];
+        int threads, chunk, tile, prefetch = DEFAULT_PREFETCH_ROWS;
+
+        // The prefetch distance was added after the timing; older entries end at the timing
+        if (strncmp(line, key, strlen(key)) != 0 ||
+            sscanf(line + strlen(key), "%63s %d %31s %d %d %*f %d", entry_engine, &threads, entry_schedule,
+                   &chunk, &tile, &prefetch) < 5) {
+            continue;
+        }
+
+        // Later entries win, so keep scanning
+        const Engine *found = find_engine(entry_engine);
+        if (found != NULL && threads > 0 && parse_schedule(entry_schedule, &config->schedule)) {
+            engine = found;
+            config->threads = threads;
+            config->chunk = chunk;
+            config->tile = tile;
+            config->prefetch = prefetch;
+        }
+    }
+
+    fclose(file);
+    return engine;
+}
+
+// Replace the profile line starting with key, or append it, keeping all other entries
+static void replace_profile_entry(const char *path, const char *key, const char *entry) {
+    char line[512];
+    char tmp_path[4096];
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *out = fopen(tmp_path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Could not write tuning profile %s\n", tmp_path);
+        return;
+    }
+
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        fprintf(out, "# host rows cols density rule engine threads schedule chunk tile seconds_per_generation prefetch\n");
+        fprintf(out, "# host crossover threads cells_per_thread\n");
+    } else {
+        while (fgets(line, sizeof(line), in) != NULL) {
+            if (strncmp(line, key, strlen(key)) != 0) {
+                fputs(line, out);
+            }
+        }
+        fclose(in);
+    }
+
+    fprintf(out, "%s%s\n", key, entry);
+    fclose(out);
+
+    if (rename(tmp_path, path) != 0) {
+        fprintf(stderr, "Could not replace tuning profile %s\n", path);
+    }
+}
+
+// Store the tuned configuration of a workload, replacing any previous entry for the same key
+void save_tuning_profile(const char *path, const Workload *workload, const Engine *engine,
+                         const EngineConfig *config, double seconds_per_generation) {
+    char key[320], entry[256];
+
+    workload_key(workload, key, sizeof(key));
+    snprintf(entry, sizeof(entry), "%s %d %s %d %d %.9f %d", engine->name, config->threads,
+             schedule_name(config->schedule), config->chunk, config->tile, seconds_per_generation, config->prefetch);
+    replace_profile_entry(path, key, entry);
+}
+
+// Look up the parallel crossover measured on this host for a team of threads
+bool load_parallel_crossover(const char *path, int threads, int *cells_per_thread) {
+    char host[256], line[512];
+    bool found = false;
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    if (gethostname(host, sizeof(host)) != 0) {
+        snprintf(host, sizeof(host), "unknown");
+    }
+    host[sizeof(host) - 1] = '\0';
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char entry_host[256];
+        int entry_threads, cells;
+
+        if (line[0] != '#' && sscanf(line, "%255s crossover %d %d", entry_host, &entry_threads, &cells) == 3 &&
+            strcmp(entry_host, host) == 0 && entry_threads == threads && cells >= 0) {
+            *cells_per_thread = cells;
+            found = true;
+        }
+    }
+
+    fclose(file);
+    return found;
+}
+
+// Store the parallel crossover measured on this host for a team of threads
+void save_parallel_crossover(const char *path, int threads, int cells_per_thread) {
+    char host[256], key[320], entry[32];
+
+    if (gethostname(host, sizeof(host)) != 0) {
+        snprintf(host, sizeof(host), "unknown");
+    }
+    host[sizeof(host) - 1] = '\0';
+
+    snprintf(key, sizeof(key), "%s crossover %d ", host, threads);
+    snprintf(entry, sizeof(entry), "%d", cells_per_thread);
+    replace_profile_entry(path, key, entry);
+}
+
+// Measure how many cells a thread must own before a parallel generation of a team of threads
+// beats a serial one. Compares the per-cell update cost with the cost of one worksharing loop and
+// its barrier. Returns -1 for a single thread, where there is nothing to measure.
+int calibrate_parallel_crossover(int threads) {
+    int max_threads = threads;
+    if (max_threads < 2) {
+        return -1;
+    }
+
+    // Per-cell cost of the serial kernel on a grid that fits in cache
+    Workload workload = {CROSSOVER_GRID, CROSSOVER_GRID, 0.3f, 4};
+    char *grid = alloc_grid(workload.rows, workload.cols);
+    EngineConfig config;
+    default_engine_config(&config);
+    initialize_workload_grid(grid, &workload);
+
+    engine_serial(grid, workload.rows, workload.cols, 1, &config);
+    double start_time = omp_get_wtime();
+    engine_serial(grid, workload.rows, workload.cols, workload.generations, &config);
+    double cell_cost = (omp_get_wtime() - start_time) / ((double)workload.rows * workload.cols * workload.generations);
+    free_grid(grid);
+
+    // Per-generation synchronization cost of a full team: an empty worksharing loop and its barrier
+    double sync_cost = 0;
+    #pragma omp parallel num_threads(max_threads)
+    {
+        #pragma omp for schedule(static)
+        for (int i = 0; i < max_threads; i++) {
+        }
+
+        double sync_start = omp_get_wtime();
+        for (int round = 0; round < CROSSOVER_SYNC_ROUNDS; round++) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < max_threads; i++) {
+            }
+        }
+
+        #pragma omp master
+        sync_cost = (omp_get_wtime() - sync_start) / CROSSOVER_SYNC_ROUNDS;
+    }
+
+    if (cell_cost <= 0) {
+        return 1;
+    }
+
+    double cells = sync_cost / cell_cost * CROSSOVER_MARGIN;
+    if (cells < 1) {
+        return 1;
+    }
+    return cells > INT_MAX ? INT_MAX : (int)cells;
+}
+
+// Set the parallel crossover for a team of threads from the profile, or measure and store it.
+// A single thread has no crossover; nothing is stored for it, so it never limits later runs.
+static void ensure_parallel_crossover(const char *path, int threads, bool remeasure) {
+    if (!remeasure && load_parallel_crossover(path, threads, &parallel_min_cells_per_thread)) {
+        return;
+    }
+    parallel_min_cells_per_thread = calibrate_parallel_crossover(threads);
+    if (parallel_min_cells_per_thread < 0) {
+        parallel_min_cells_per_thread = 0;
+        return;
+    }
+    save_parallel_crossover(path, threads, parallel_min_cells_per_thread);
+}
+
+// Number of threads worth using on a grid: no more than leave each thread parallel_min_cells_per_thread cells
+int parallel_team_size(int rows, int cols, int requested) {
+    if (requested < 1) {
+        requested = 1;
+    }
+    if (parallel_min_cells_per_thread <= 0) {
+        return requested;
+    }
+
+    long long team = (long long)rows * cols / parallel_min_cells_per_thread;
+    if (team < 1) {
+        return 1;
+    }
+    return team < requested ? (int)team : requested;
+}
+
+// Run a runtime-sized workload, optionally tuning it first, and report its timing
+int run_workload(const Workload *workload, const char *engine_name, const EngineConfig *overrides,
+                 const char *profile_path, bool tune, bool verify, bool print_final) {
+    char default_path[4096];
+    const Engine *engine = NULL;
+    const char *source = "defaults";
+    EngineConfig config;
+
+    if (profile_path == NULL) {
+        const char *home = getenv("HOME");
+        snprintf(default_path, sizeof(default_path), "%s%s%s", home ? home : "", home ? "/" : "", TUNE_PROFILE_FILE);
+        profile_path = default_path;
+    }
+
+    default_engine_config(&config);
+
+    // Small-grid fast path: the crossover comes from the command line, the profile or a fresh
+    // measurement for the requested team size
+    if (parallel_min_cells_per_thread < 0) {
+        ensure_parallel_crossover(profile_path, overrides->threads > 0 ? overrides->threads : omp_get_max_threads(),
+                                  tune);
+    }
+
+    if (engine_name != NULL) {
+        engine = find_engine(engine_name);
+        if (engine == NULL) {
+            fprintf(stderr, "Unknown engine '%s' (see --help)\n", engine_name);
+            return 1;
+        }
+        if (active_boundary->fill != fill_halo_torus && !engine->bounded) {
+            fprintf(stderr, "Engine '%s' only runs on the torus (use halo for the %s boundary)\n", engine_name,
+                    active_boundary->name);
+            return 1;
+        }
+        if (active_rule.states > 2 && !engine->multistate) {
+            fprintf(stderr, "Engine '%s' only runs two-state rules (use generations or genref)\n", engine_name);
+            return 1;
+        }
+        if ((active_ltl.radius > 0) != engine->ranged) {
+            fprintf(stderr, "Engine '%s' %s Larger-than-Life rules (use %s)\n", engine_name,
+                    engine->ranged ? "only runs" : "does not run", engine->ranged ? "--rule R..." : "ltl or ltlref");
+            return 1;
+        }
+        source = "command line";
+    } else if (tune) {
+        double seconds_per_generation = 0;
+        engine = tune_workload(workload, &config, &seconds_per_generation);
+        if (engine == NULL) {
+            fprintf(stderr, "Tuning found no consistent configuration\n");
+            return 1;
+        }
+        save_tuning_profile(profile_path, workload, engine, &config, seconds_per_generation);
+        printf("Stored tuned configuration in %s\n\n", profile_path);
+        source = "tuning";
+    } else {
+        engine = load_tuning_profile(profile_path, workload, &config);
+        if (engine != NULL) {
+            source = "tuning profile";
+        } else {
+            engine = default_engine();
+        }
+    }
+
+    // Explicit settings always win over tuned ones
+    if (overrides->threads > 0) config.threads = overrides->threads;
+    if (overrides->schedule != 0) config.schedule = overrides->schedule;
+    if (overrides->chunk >= 0) config.chunk = overrides->chunk;
+    if (overrides->tile > 0) config.tile = overrides->tile;
+    if (overrides->prefetch >= 0) config.prefetch = overrides->prefetch;
+
+    char rule[32];
+    format_active_rule(rule, sizeof(rule));
+    printf("Running %dx%d workload for %d generations under %s (%s boundary)\n", workload->rows, workload->cols,
+           workload->generations, rule, active_boundary->name);
+    printf("  Engine: %s (from %s)\n", engine->name, source);
+    if (engine->parallel) {
+        printf("  Threads: %d of %d requested (crossover: %d cells per thread)\n",
+               parallel_team_size(workload->rows, workload->cols, config.threads), config.threads,
+               parallel_min_cells_per_thread);
+    }
+    if (engine->scheduled) printf("  Schedule: %s, chunk %d\n", schedule_name(config.schedule), config.chunk);
+    if (engine->tiled) printf("  Tile: %d\n", config.tile);
+    if (engine->streams) {
+        if (grid_streams(workload->rows, workload->cols)) {
+            printf("  Streaming stores: on (prefetch %d rows ahead, LLC %zu KB)\n", config.prefetch,
+                   last_level_cache_bytes() / 1024);
+        } else {
+            printf("  Streaming stores: off (grid fits the %zu KB LLC)\n", last_level_cache_bytes() / 1024);
+        }
+    }
+
+    grid_bytes_peak = grid_bytes_in_use;
+    char *grid = alloc_grid(workload->rows, workload->cols);
+    initialize_workload_grid(grid, workload);
+
+    if (publish_name != NULL && !publish_open(publish_name, workload->rows, workload->cols)) {
+        free_grid(grid);
+        return 1;
+    }
+
+    long long counts[PERF_EVENT_COUNT];
+    bool counting = perf_counters_begin();
+    double start_time = omp_get_wtime();
+    if (published != NULL && engine->observed) {
+        // Readers see every generation: observing engines publish from inside their generation loop
+        publish_generation(grid, 0);
+        config.on_generation = publish_generation;
+        engine->run(grid, workload->rows, workload->cols, workload->generations, &config);
+    } else if (published != NULL) {
+        // Other engines are stepped one generation at a time, repeating their per-run setup
+        publish_generation(grid, 0);
+        for (int generation = 1; generation <= workload->generations; generation++) {
+            engine->run(grid, workload->rows, workload->cols, 1, &config);
+            publish_generation(grid, generation);
+        }
+    } else {
+        engine->run(grid, workload->rows, workload->cols, workload->generations, &config);
+    }
+    double time_taken = omp_get_wtime() - start_time;
+    perf_counters_end(counts);
+
+    printf("  Time taken: %.4f seconds (%.6f seconds per generation)\n", time_taken, time_taken / workload->generations);
+    printf("  Live cells: %d\n", count_live(grid, workload->rows, workload->cols));
+    printf("  Peak grid memory: %.2f MB (%.2f grids)\n", grid_bytes_peak / (1024.0 * 1024.0),
+           (double)grid_bytes_peak / ((double)workload->rows * workload->cols));
+    print_grid_pool_report();
+    if (published != NULL) {
+        printf("  Published: %s (%d generations %s, two %.2f MB slots)\n", published_path, workload->generations,
+               engine->observed ? "from the engine's generation loop" :
+               "stepped one at a time, repeating the engine's per-run setup each generation",
+               (double)workload->rows * workload->cols / (1024.0 * 1024.0));
+        publish_close();
+    }
+    if (engine->run == engine_pow2) {
+        printf("  Kernel: %s\n", select_row_kernel(workload->cols) == update_row_generic ?
+               "generic (no specialization for this width)" : "specialized for a power-of-two width");
+    }
+    if (engine->run == engine_memo && memo_hits + memo_misses > 0) {
+        printf("  Memo cache: %.1f%% hits (%lld of %lld tiles), %.2f MB of tables\n",
+               100.0 * memo_hits / (memo_hits + memo_misses), memo_hits, memo_hits + memo_misses,
+               memo_table_bytes / (1024.0 * 1024.0));
+    }
+    if (engine->run == engine_stealing) {
+        printf("  Tiles: %lld computed (%lld stolen), %lld quiescent tiles skipped\n", stealing_tiles_computed,
+               stealing_tiles_stolen, stealing_tiles_skipped);
+    }
+#ifdef __linux__
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (counting && counts[e] >= 0) {
+            printf("  %s: %lld (%.4f per cell and generation)\n", perf_events[e].name, counts[e],
+                   counts[e] / ((double)workload->rows * workload->cols * workload->generations));
+        } else {
+            printf("  %s: n/a\n", perf_events[e].name);
+        }
+    }
+#else
+    (void)counting;
+#endif
+
+    // The workload seed is fixed, so the reference starts from the same world
+    bool identical = true;
+    if (verify) {
+        const Engine *reference_run = reference_engine();
+        EngineConfig reference_config;
+        char *reference = alloc_grid(workload->rows, workload->cols);
+
+        default_engine_config(&reference_config);
+        initialize_workload_grid(reference, workload);
+        reference_run->run(reference, workload->rows, workload->cols, workload->generations, &reference_config);
+        identical = memcmp(grid, reference, (size_t)workload->rows * workload->cols) == 0;
+        printf("  Verified against %s: %s\n", reference_run->name,
+               identical ? "identical final grid" : "FINAL GRID DIFFERS");
+        free_grid(reference);
+    }
+
+    if (print_final) {
+        printf("\nFinal grid state (after %d iterations):\n", workload->generations);
+        print_workload_grid(grid, workload->rows, workload->cols);
+    }
+
+    free_grid(grid);
+    return identical ? 0 : 1;
+}
+
+// Create the shared-memory segment a run publishes into. Names without a leading slash get one.
+bool publish_open(const char *name, int rows, int cols) {
+    size_t cells = (size_t)rows * cols;
+
+    snprintf(published_path, sizeof(published_path), "%s%s", name[0] == '/' ? "" : "/", name);
+    published_bytes = PUBLISH_HEADER + 2 * cells;
+
+    int fd = shm_open(published_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("shm_open");
+        return false;
+    }
+    if (ftruncate(fd, (off_t)published_bytes) != 0) {
+        perror("ftruncate");
+        close(fd);
+        shm_unlink(published_path);
+        return false;
+    }
+    void *segment = mmap(NULL, published_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        perror("mmap");
+        shm_unlink(published_path);
+        return false;
+    }
+
+    // A fresh segment is zero-filled: both sequences even, no generation published yet
+    published = segment;
+    published->rows = rows;
+    published->cols = cols;
+    atomic_store_explicit(&published->latest, -1, memory_order_relaxed);
+    atomic_store_explicit(&published->magic, PUBLISH_MAGIC, memory_order_release);
+    return true;
+}
+
+// Copy a generation into the slot readers are not directed to, under that slot's sequence lock
+void publish_generation(const char *grid, long long generation) {
+    size_t cells = (size_t)published->rows * published->cols;
+    int slot = atomic_load_explicit(&published->latest, memory_order_relaxed) == 0 ? 1 : 0;
+    unsigned long long sequence = atomic_load_explicit(&published->sequence[slot], memory_order_relaxed);
+
+    atomic_store_explicit(&published->sequence[slot], sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy((char *)published + PUBLISH_HEADER + slot * cells, grid, cells);
+    published->generation[slot] = generation;
+    atomic_store_explicit(&published->sequence[slot], sequence + 2, memory_order_release);
+    atomic_store_explicit(&published->latest, slot, memory_order_release);
+}
+
+// Tell readers the run is over and remove the segment; mapped readers keep their view
+void publish_close() {
+    atomic_store_explicit(&published->finished, 1, memory_order_release);
+    munmap(published, published_bytes);
+    shm_unlink(published_path);
+    published = NULL;
+}
+
+// Read the newest published generation in place: its number and live cells, and a copy of the
+// cells when copy is not NULL. Returns false if the writer overwrote the slot during the read.
+static bool read_published(const SharedGrid *shared, long long *generation, int *live, char *copy) {
+    int slot = atomic_load_explicit(&shared->latest, memory_order_acquire);
+    if (slot < 0) {
+        return false;
+    }
+
+    const char *cells = (const char *)shared + PUBLISH_HEADER + (size_t)slot * shared->rows * shared->cols;
+    unsigned long long before = atomic_load_explicit(&shared->sequence[slot], memory_order_acquire);
+    if (before % 2 != 0) {
+        return false;
+    }
+    *generation = shared->generation[slot];
+    *live = count_live(cells, shared->rows, shared->cols);
+    if (copy != NULL) {
+        memcpy(copy, cells, (size_t)shared->rows * shared->cols);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&shared->sequence[slot], memory_order_relaxed) == before;
+}
+
+// Follow a run published under name: wait for the segment, report every generation seen
+// (readers never block the writer, so slow readers skip generations) and stop when it ends
+int attach_published(const char *name, bool print_final) {
+    char path[256];
+    struct stat info;
+    int fd = -1;
+    double deadline = omp_get_wtime() + ATTACH_WAIT_SECONDS;
+
+    snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+    while ((fd = shm_open(path, O_RDONLY, 0)) < 0 || fstat(fd, &info) != 0 ||
+           (size_t)info.st_size < PUBLISH_HEADER) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        if (omp_get_wtime() > deadline) {
+            fprintf(stderr, "No grid published as %s\n", path);
+            return 1;
+        }
+        usleep(1000);
+    }
+
+    size_t bytes = (size_t)info.st_size;
+    const SharedGrid *shared = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    while (atomic_load_explicit(&shared->magic, memory_order_acquire) != PUBLISH_MAGIC) {
+        usleep(1000);
+    }
+
+    int rows = shared->rows;
+    int cols = shared->cols;
+    char *snapshot = print_final ? alloc_grid(rows, cols) : NULL;
+    long long last = -1, seen = 0, retries = 0;
+    int live = 0;
+
+    printf("Attached to %s: %dx%d grid\n", path, rows, cols);
+    for (;;) {
+        bool finished = atomic_load_explicit(&shared->finished, memory_order_acquire) != 0;
+        long long generation;
+        int count;
+
+        if (read_published(shared, &generation, &count, snapshot)) {
+            if (generation != last) {
+                printf("  Generation %lld: %d live cells", generation, count);
+                if (last >= 0 && generation > last + 1) {
+                    printf(" (%lld skipped)", generation - last - 1);
+                }
+                printf("\n");
+                last = generation;
+                live = count;
+                seen++;
+            }
+            if (finished) {
+                break;
+            }
+        } else if (atomic_load_explicit(&shared->latest, memory_order_relaxed) >= 0) {
+            retries++;
+            continue;
+        }
+        usleep(1000);
+    }
+
+    printf("Read %lld of %lld generations (%lld torn reads retried), final live cells: %d\n", seen, last + 1,
+           retries, live);
+    if (snapshot != NULL) {
+        printf("\nFinal grid state (generation %lld):\n", last);
+        print_workload_grid(snapshot, rows, cols);
+        free_grid(snapshot);
+    }
+    munmap((void *)shared, bytes);
+    return 0;
+}
+
+// Wrap an accepted socket, with one reference for its connection thread
+static ServiceClient *open_service_client(int socket) {
+    ServiceClient *client = malloc(sizeof(ServiceClient));
+    struct timeval timeout = {SERVICE_SEND_TIMEOUT, 0};
+
+    if (client == NULL) {
+        return NULL;
+    }
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    client->socket = socket;
+    pthread_mutex_init(&client->send_lock, NULL);
+    atomic_init(&client->references, 1);
+    client->broken = false;
+    return client;
+}
+
+// Drop a reference to a client, closing its socket with the last one
+static void release_service_client(ServiceClient *client) {
+    if (atomic_fetch_sub(&client->references, 1) == 1) {
+        close(client->socket);
+        pthread_mutex_destroy(&client->send_lock);
+        free(client);
+    }
+}
+
+// Send a whole message to a service client (send lock held); clients that went away or stopped
+// reading are ignored
+static void service_send_locked(ServiceClient *client, const char *text, size_t len) {
+    while (len > 0 && !client->broken) {
+        ssize_t sent = send(client->socket, text, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            client->broken = true;
+            break;
+        }
+        text += sent;
+        len -= (size_t)sent;
+    }
+}
+
+// Send a whole message to a service client
+static void service_send(ServiceClient *client, const char *text, size_t len) {
+    pthread_mutex_lock(&client->send_lock);
+    service_send_locked(client, text, len);
+    pthread_mutex_unlock(&client->send_lock);
+}
+
+// printf-style reply to a service client
+static void service_reply(ServiceClient *client, const char *format, ...) {
+    char text[SERVICE_LINE];
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    service_send(client, text, len < (int)sizeof(text) ? (size_t)len : sizeof(text) - 1);
+}
+
+// Parse "run key=value ..." into a job. Keys: size=RxC, density=D (0 or absent: centered block),
+// generations=N, rule=RULE, engine=NAME, threads=N, boundary=NAME, weight=W, deadline=SECONDS;
+// a bare "print" returns the grid.
+static bool parse_service_job(char *line, ServiceJob *job, char *error, size_t error_len) {
+    job->workload = (Workload){GRID_SIZE, GRID_SIZE, 0.0f, ITERATIONS};
+    job->engine_name = NULL;
+    job->threads = 0;
+    job->rule = (Rule){1 << 3, (1 << 2) | (1 << 3), 2};
+    job->ltl.radius = 0;
+    job->boundary = &boundaries[0];
+    job->print = false;
+    job->weight = 1.0;
+    job->deadline = 0.0;
+
+    char *state = NULL;
+    for (char *token = strtok_r(line, " \t", &state); token != NULL; token = strtok_r(NULL, " \t", &state)) {
+        char *value = strchr(token, '=');
+        if (strcmp(token, "print") == 0) {
+            job->print = true;
+            continue;
+        }
+        if (value == NULL) {
+            snprintf(error, error_len, "expected key=value, got '%s'", token);
+            return false;
+        }
+        *value++ = '\0';
+
+        bool valid = true;
+        if (strcmp(token, "size") == 0) {
+            valid = sscanf(value, "%dx%d", &job->workload.rows, &job->workload.cols) == 2 &&
+                    job->workload.rows >= 3 && job->workload.cols >= 3 &&
+                    (long long)job->workload.rows * job->workload.cols <= SERVICE_MAX_CELLS;
+        } else if (strcmp(token, "density") == 0) {
+            job->workload.density = (float)atof(value);
+            valid = job->workload.density >= 0.0f && job->workload.density <= 1.0f;
+        } else if (strcmp(token, "generations") == 0) {
+            job->workload.generations = atoi(value);
+            valid = job->workload.generations > 0;
+        } else if (strcmp(token, "rule") == 0) {
+            valid = (value[0] == 'R' || value[0] == 'r') ? parse_ltl_rule(value, &job->ltl)
+                                                         : parse_rule(value, &job->rule);
+        } else if (strcmp(token, "engine") == 0) {
+            snprintf(job->engine_text, sizeof(job->engine_text), "%s", value);
+            job->engine_name = job->engine_text;
+            valid = find_engine(value) != NULL;
+        } else if (strcmp(token, "threads") == 0) {
+            job->threads = atoi(value);
+            valid = job->threads > 0;
+        } else if (strcmp(token, "boundary") == 0) {
+            job->boundary = find_boundary(value);
+            valid = job->boundary != NULL;
+        } else if (strcmp(token, "weight") == 0) {
+            job->weight = atof(value);
+            valid = job->weight > 0;
+        } else if (strcmp(token, "deadline") == 0) {
+            job->deadline = atof(value);
+            valid = job->deadline > 0;
+        } else {
+            snprintf(error, error_len, "unknown key '%s'", token);
+            return false;
+        }
+        if (!valid) {
+            snprintf(error, error_len, "invalid %s '%s'", token, value);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Install a world's rule and boundary as the active ones
+static void activate_world(const ServiceJob *job) {
+    active_rule = job->rule;
+    active_ltl = job->ltl;
+    active_boundary = job->boundary;
+}
+
+// Pick the engine and settings of a world and build its initial grid. Returns NULL, or why the
+// world cannot run.
+static const char *start_world(ServiceJob *job, const char *profile_path) {
+    activate_world(job);
+    default_engine_config(&job->config);
+    if (job->engine_name != NULL) {
+        job->engine = find_engine(job->engine_name);
+    } else if ((job->engine = load_tuning_profile(profile_path, &job->workload, &job->config)) == NULL) {
+        job->engine = default_engine();
+    }
+    if (job->threads > 0) {
+        job->config.threads = job->threads;
+    }
+    if (!engine_supports_workload(job->engine) ||
+        (active_boundary->fill != fill_halo_torus && (active_rule.states > 2 || active_ltl.radius > 0))) {
+        return "engine does not run this rule and boundary";
+    }
+
+    // The probe for the engine's scratch grid goes back to the pool, where the engine finds it
+    job->grid = try_alloc_grid(job->workload.rows, job->workload.cols);
+    char *scratch = job->grid != NULL ? try_alloc_grid(job->workload.rows, job->workload.cols) : NULL;
+    if (scratch == NULL) {
+        free_grid(job->grid);
+        job->grid = NULL;
+        return "out of memory for the grid";
+    }
+    free_grid(scratch);
+    initialize_workload_grid(job->grid, &job->workload);
+    job->first_slice_at = omp_get_wtime();
+    return NULL;
+}
+
+// Choose the world to run next. The world with the least weighted run time (vruntime) gets the
+// next slice, unless a world's deadline is at risk: when its estimated remaining work comes within
+// SERVICE_SLACK or a quarter of that work of the time left, the earliest such deadline goes first.
+// Distant deadlines thus never starve other worlds, however large the world.
+static ServiceJob *pick_world(double now) {
+    ServiceJob *earliest = NULL;
+    ServiceJob *fairest = NULL;
+
+    for (ServiceJob *job = service.head; job != NULL; job = job->next) {
+        double due = job->queued_at + job->deadline;
+        double work = job->generation_cost * (job->workload.generations - job->generations_done);
+        double margin = work / 4 > SERVICE_SLACK ? work / 4 : SERVICE_SLACK;
+        bool urgent = job->deadline > 0 && now < due && due - now - work <= margin;
+        if (urgent && (earliest == NULL || due < earliest->queued_at + earliest->deadline)) {
+            earliest = job;
+        }
+        if (fairest == NULL || job->vruntime < fairest->vruntime) {
+            fairest = job;
+        }
+    }
+    return earliest != NULL ? earliest : fairest;
+}
+
+// Unlink a world from the service list (service lock held)
+static void remove_world(ServiceJob *job) {
+    ServiceJob **link = &service.head;
+    ServiceJob *previous = NULL;
+
+    while (*link != job) {
+        previous = *link;
+        link = &(*link)->next;
+    }
+    *link = job->next;
+    if (service.tail == job) {
+        service.tail = previous;
+    }
+    service.depth--;
+}
+
+// Fold a finished world into the service statistics, take it off the list, then send its result,
+// so a client that asks for stats after the result already sees the world counted
+static void finish_world(ServiceJob *job) {
+    const Workload *workload = &job->workload;
+    double finished = omp_get_wtime();
+    double latency = finished - job->queued_at;
+    double cell_generations = (double)workload->rows * workload->cols * workload->generations;
+    bool missed = job->deadline > 0 && latency > job->deadline;
+    char deadline[64] = "";
+
+    pthread_mutex_lock(&service.lock);
+    service.completed++;
+    service.latency_total += latency;
+    service.run_total += job->run_time;
+    service.cell_generations += cell_generations;
+    if (latency > service.latency_max) {
+        service.latency_max = latency;
+    }
+    if (job->deadline > 0) {
+        service.deadlines++;
+        service.deadlines_missed += missed;
+    }
+    remove_world(job);
+    pthread_mutex_unlock(&service.lock);
+
+    if (job->deadline > 0) {
+        snprintf(deadline, sizeof(deadline), ", deadline %.3f s %s", job->deadline, missed ? "missed" : "met");
+    }
+    service_reply(job->client,
+                  "done job %lld: engine %s, %d threads, %dx%d for %d generations, live %d, "
+                  "run %.6f s (%.1f Mcells/s) in %d slices, queued %.6f s, latency %.6f s%s\n",
+                  job->id, job->engine->name,
+                  parallel_team_size(workload->rows, workload->cols, job->config.threads),
+                  workload->rows, workload->cols, workload->generations,
+                  count_live(job->grid, workload->rows, workload->cols), job->run_time,
+                  cell_generations / job->run_time / 1e6, job->slices, job->first_slice_at - job->queued_at,
+                  latency, deadline);
+    if (job->print) {
+        size_t len = (size_t)workload->rows * (workload->cols + 1);
+        char *text = malloc(len);
+        if (text != NULL) {
+            for (int i = 0; i < workload->rows; i++) {
+                char *line = text + (size_t)i * (workload->cols + 1);
+                for (int j = 0; j < workload->cols; j++) {
+                    line[j] = cell_symbol(job->grid[(size_t)i * workload->cols + j]);
+                }
+                line[workload->cols] = '\n';
+            }
+            service_send(job->client, text, len);
+            free(text);
+        }
+        service_reply(job->client, "end job %lld\n", job->id);
+    }
+}
+
+// Runner thread: time-slices the generations of every active world on one warm OpenMP team, so
+// worlds never compete with nested teams. A slice runs as many generations of the chosen world as
+// fit SERVICE_SLICE at its measured cost, so small worlds finish within a few slices while large
+// ones share the remaining time in proportion to their weights.
+static void *service_runner(void *arg) {
+    const char *profile_path = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&service.lock);
+        while (service.head == NULL && !service.stopping) {
+            pthread_cond_wait(&service.ready, &service.lock);
+        }
+        if (service.head == NULL) {
+            pthread_mutex_unlock(&service.lock);
+            return NULL;
+        }
+        ServiceJob *job = pick_world(omp_get_wtime());
+        pthread_mutex_unlock(&service.lock);
+
+        const char *error = job->grid == NULL ? start_world(job, profile_path) : NULL;
+        if (error != NULL) {
+            pthread_mutex_lock(&service.lock);
+            service.failed++;
+            remove_world(job);
+            pthread_mutex_unlock(&service.lock);
+            service_reply(job->client, "error job %lld: %s (engine %s)\n", job->id, error, job->engine->name);
+        } else {
+            int remaining = job->workload.generations - job->generations_done;
+            int generations = job->generation_cost > 0 ? (int)(SERVICE_SLICE / job->generation_cost) : 1;
+            generations = generations < 1 ? 1 : generations > remaining ? remaining : generations;
+
+            activate_world(job);
+            double start = omp_get_wtime();
+            job->engine->run(job->grid, job->workload.rows, job->workload.cols, generations, &job->config);
+            double elapsed = omp_get_wtime() - start;
+
+            pthread_mutex_lock(&service.lock);
+            job->generations_done += generations;
+            job->slices++;
+            job->run_time += elapsed;
+            job->generation_cost = elapsed / generations;
+            job->vruntime += elapsed / job->weight;
+            service.vclock = job->vruntime;
+            pthread_mutex_unlock(&service.lock);
+        }
+
+        if (error != NULL || job->generations_done == job->workload.generations) {
+            if (error == NULL) {
+                finish_world(job);
+            }
+            release_service_client(job->client);
+            if (job->grid != NULL) {
+                free_grid(job->grid);
+            }
+            free(job);
+        }
+    }
+}
+
+// Answer the stats command: completed worlds, latency from submission to result, throughput,
+// deadlines and the progress of every active world
+static void reply_service_stats(ServiceClient *client) {
+    char text[SERVICE_LINE * 8];
+    size_t len = 0;
+
+    pthread_mutex_lock(&service.lock);
+    double uptime = omp_get_wtime() - service.started;
+    long long completed = service.completed;
+    double mean_latency = completed > 0 ? service.latency_total / completed : 0;
+    double mean_run = completed > 0 ? service.run_total / completed : 0;
+    len += snprintf(text + len, sizeof(text) - len,
+                    "stats: %lld done, %lld failed, %d active; latency mean %.6f s, max %.6f s; run mean %.6f s; "
+                    "throughput %.2f jobs/s, %.1f Mcells/s over %.1f s; deadlines missed %lld of %lld\n",
+                    completed, service.failed, service.depth, mean_latency, service.latency_max, mean_run,
+                    completed / uptime, service.cell_generations / uptime / 1e6, uptime, service.deadlines_missed,
+                    service.deadlines);
+    for (ServiceJob *job = service.head; job != NULL && len < sizeof(text) - SERVICE_LINE; job = job->next) {
+        len += snprintf(text + len, sizeof(text) - len,
+                        "  job %lld: %dx%d, %d of %d generations, weight %.2f, deadline %.3f s, %d slices, "
+                        "run %.6f s, vruntime %.6f\n",
+                        job->id, job->workload.rows, job->workload.cols, job->generations_done,
+                        job->workload.generations, job->weight, job->deadline, job->slices, job->run_time,
+                        job->vruntime);
+    }
+    pthread_mutex_unlock(&service.lock);
+    service_send(client, text, len);
+}
+
+// Handle one request line of a client
+static void handle_service_line(ServiceClient *client, char *line) {
+    char error[128];
+
+    if (strncmp(line, "run", 3) == 0 && (line[3] == ' ' || line[3] == '\0')) {
+        ServiceJob *job = malloc(sizeof(ServiceJob));
+        if (job == NULL) {
+            service_reply(client, "error: out of memory\n");
+            return;
+        }
+        if (!parse_service_job(line + 3, job, error, sizeof(error))) {
+            service_reply(client, "error: %s\n", error);
+            free(job);
+            return;
+        }
+        job->client = client;
+        job->next = NULL;
+        job->queued_at = omp_get_wtime();
+        job->engine = NULL;
+        job->grid = NULL;
+        job->generations_done = 0;
+        job->slices = 0;
+        job->generation_cost = 0;
+        job->run_time = 0;
+
+        // Hold the client's send lock from the insertion until the acknowledgement is sent, so it
+        // always goes out before the runner can send this job's result. Once the service lock is
+        // released the runner may finish and free the job, so only the copied id is used after it.
+        char text[SERVICE_LINE];
+        long long id = 0;
+        pthread_mutex_lock(&client->send_lock);
+        pthread_mutex_lock(&service.lock);
+        bool stopping = service.stopping;
+        int active = service.depth + 1;
+        if (!stopping) {
+            atomic_fetch_add(&client->references, 1);
+            job->id = id = service.next_id++;
+            job->vruntime = service.vclock;
+            if (service.tail != NULL) {
+                service.tail->next = job;
+            } else {
+                service.head = job;
+            }
+            service.tail = job;
+            service.depth++;
+            pthread_cond_signal(&service.ready);
+        }
+        pthread_mutex_unlock(&service.lock);
+        if (!stopping) {
+            int len = snprintf(text, sizeof(text), "queued job %lld (%d active)\n", id, active);
+            service_send_locked(client, text, (size_t)len);
+        }
+        pthread_mutex_unlock(&client->send_lock);
+
+        if (stopping) {
+            service_reply(client, "error: shutting down\n");
+            free(job);
+        }
+    } else if (strcmp(line, "stats") == 0) {
+        reply_service_stats(client);
+    } else if (strcmp(line, "shutdown") == 0) {
+        pthread_mutex_lock(&service.lock);
+        service.stopping = true;
+        int active = service.depth;
+        pthread_cond_signal(&service.ready);
+        pthread_mutex_unlock(&service.lock);
+        service_reply(client, "shutting down after %d active jobs\n", active);
+        shutdown(service.listener, SHUT_RDWR);
+    } else if (line[0] != '\0') {
+        service_reply(client, "error: unknown command (run, stats, shutdown)\n");
+    }
+}
+
+// Connection thread: splits the client's input into lines until it disconnects
+static void *service_connection(void *arg) {
+    ServiceClient *client = arg;
+    char buffer[SERVICE_LINE];
+    size_t used = 0;
+
+    for (;;) {
+        ssize_t received = recv(client->socket, buffer + used, sizeof(buffer) - 1 - used, 0);
+        if (received <= 0) {
+            break;
+        }
+        used += (size_t)received;
+        buffer[used] = '\0';
+
+        char *line = buffer;
+        char *end;
+        while ((end = strchr(line, '\n')) != NULL) {
+            *end = '\0';
+            if (end > line && end[-1] == '\r') {
+                end[-1] = '\0';
+            }
+            handle_service_line(client, line);
+            line = end + 1;
+        }
+        used = strlen(line);
+        memmove(buffer, line, used);
+        if (used == sizeof(buffer) - 1) {
+            service_reply(client, "error: line too long\n");
+            used = 0;
+        }
+    }
+    release_service_client(client);
+    return NULL;
+}
+
+// Long-running service mode: accept jobs on a Unix-domain socket and run them on one warm team
+int serve_requests(const char *path, const char *profile_path) {
+    char default_path[4096];
+    struct sockaddr_un address;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path '%s' is too long\n", path);
+        return 1;
+    }
+    if (profile_path == NULL) {
+        const char *home = getenv("HOME");
+        snprintf(default_path, sizeof(default_path), "%s%s%s", home ? home : "", home ? "/" : "", TUNE_PROFILE_FILE);
+        profile_path = default_path;
+    }
+
+    // Pay the startup costs once: crossover calibration and the OpenMP team
+    if (parallel_min_cells_per_thread < 0) {
+        ensure_parallel_crossover(profile_path, omp_get_max_threads(), false);
+    }
+
+    service.listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (service.listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", path);
+    unlink(path);
+    if (bind(service.listener, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(service.listener, SOMAXCONN) != 0) {
+        perror("bind");
+        close(service.listener);
+        return 1;
+    }
+
+    pthread_t runner;
+    service.started = omp_get_wtime();
+    if (pthread_create(&runner, NULL, service_runner, (void *)profile_path) != 0) {
+        fprintf(stderr, "Could not start the service runner\n");
+        close(service.listener);
+        unlink(path);
+        return 1;
+    }
+    printf("Serving simulation jobs on %s (crossover: %d cells per thread)\n", path, parallel_min_cells_per_thread);
+    fflush(stdout);
+
+    for (;;) {
+        int socket = accept(service.listener, NULL, NULL);
+        if (socket < 0) {
+            break;
+        }
+        ServiceClient *client = open_service_client(socket);
+        pthread_t connection;
+        if (client == NULL || pthread_create(&connection, NULL, service_connection, client) != 0) {
+            if (client != NULL) {
+                release_service_client(client);
+            } else {
+                close(socket);
+            }
+            continue;
+        }
+        pthread_detach(connection);
+    }
+
+    pthread_join(runner, NULL);
+    close(service.listener);
+    unlink(path);
+    printf("Served %lld jobs (%lld failed)\n", service.completed, service.failed);
+    return 0;
+}
+
+// Time a scheduled engine for every schedule kind and chunk sizes from 1 up to a full band per thread.
+// Prints an aligned table and the same matrix as CSV (schedule rows, chunk columns) for heatmaps.
+int sweep_schedules(const Workload *workload, const char *engine_name, const EngineConfig *overrides) {
+    int rows = workload->rows;
+    int cols = workload->cols;
+    const Engine *engine = find_engine(engine_name != NULL ? engine_name : "rows");
+    EngineConfig config;
+
+    if (engine == NULL || !engine->scheduled) {
+        fprintf(stderr, "Schedule sweeps need a scheduled engine (see --help)\n");
+        return 1;
+    }
+
+    // Measure the requested team as is; the small-grid path would hide the schedule effects
+    if (parallel_min_cells_per_thread < 0) {
+        parallel_min_cells_per_thread = 0;
+    }
+
+    default_engine_config(&config);
+    if (overrides->threads > 0) config.threads = overrides->threads;
+    if (overrides->tile > 0) config.tile = overrides->tile;
+    if (overrides->prefetch >= 0) config.prefetch = overrides->prefetch;
+
+    int items = engine_work_items(engine, rows, cols, &config);
+    int band = (items + config.threads - 1) / config.threads;
+
+    // Chunk sizes: powers of two, ending with exactly one band per thread
+    int chunks[32];
+    int chunk_count = 0;
+    for (int chunk = 1; chunk < band && chunk_count < 31; chunk *= 2) {
+        chunks[chunk_count++] = chunk;
+    }
+    chunks[chunk_count++] = band;
+
+    double times[SCHEDULE_KIND_COUNT][32];
+    char *initial = alloc_grid(rows, cols);
+    char *reference = alloc_grid(rows, cols);
+    char *work = alloc_grid(rows, cols);
+    int inconsistent = 0;
+
+    initialize_workload_grid(initial, workload);
+    memcpy(reference, initial, (size_t)rows * cols);
+    engine_serial(reference, rows, cols, workload->generations, &config);
+
+    printf("Schedule sweep: %s engine, %dx%d grid, %d generations, %d threads, %d work items\n",
+           engine->name, rows, cols, workload->generations, config.threads, items);
+
+    for (int k = 0; k < SCHEDULE_KIND_COUNT; k++) {
+        for (int c = 0; c < chunk_count; c++) {
+            config.schedule = schedule_kinds[k].kind;
+            config.chunk = chunks[c];
+            times[k][c] = time_engine(engine, initial, work, rows, cols, workload->generations, &config) /
+                          workload->generations;
+            if (memcmp(work, reference, (size_t)rows * cols) != 0) {
+                inconsistent++;
+            }
+        }
+    }
+
+    // Aligned table in milliseconds per generation
+    printf("\nMilliseconds per generation (rows: schedule, columns: chunk size%s)\n",
+           chunk_count > 1 ? ", last column is one full band" : "");
+    printf("%-22s", "schedule");
+    for (int c = 0; c < chunk_count; c++) {
+        printf(" %9d", chunks[c]);
+    }
+    printf("\n");
+
+    int best_k = 0, best_c = 0;
+    for (int k = 0; k < SCHEDULE_KIND_COUNT; k++) {
+        printf("%-22s", schedule_kinds[k].name);
+        for (int c = 0; c < chunk_count; c++) {
+            printf(" %9.4f", times[k][c] * 1000);
+            if (times[k][c] < times[best_k][best_c]) {
+                best_k = k;
+                best_c = c;
+            }
+        }
+        printf("\n");
+    }
+
+    // Heatmap-ready matrix
+    printf("\nCSV:\nschedule");
+    for (int c = 0; c < chunk_count; c++) {
+        printf(",%d", chunks[c]);
+    }
+    printf("\n");
+    for (int k = 0; k < SCHEDULE_KIND_COUNT; k++) {
+        printf("%s", schedule_kinds[k].name);
+        for (int c = 0; c < chunk_count; c++) {
+            printf(",%.9f", times[k][c]);
+        }
+        printf("\n");
+    }
+
+    printf("\nBest: %s, chunk %d (%.4f ms per generation)", schedule_kinds[best_k].name, chunks[best_c],
+           times[best_k][best_c] * 1000);
+    printf(" vs. the TODO's static,1: %.4f ms\n", times[0][0] * 1000);
+    if (inconsistent > 0) {
+        printf("WARNING: %d configurations produced a final grid different from the serial reference\n", inconsistent);
+    }
+
+    free_grid(work);
+    free_grid(reference);
+    free_grid(initial);
+    return inconsistent > 0 ? 1 : 0;
+}
+
+// Compare the row, band and 2D-block engines on grids of the workload's area reshaped from square
+// to wide and short, where parallelizing rows alone runs out of work items
+int sweep_aspect_ratios(const Workload *workload, const EngineConfig *overrides) {
+    static const char *names[] = {"rows", "tiled", "collapse", "blocked"};
+    static const int aspects[] = {1, 4, 16, 64, 256, 1024};
+    int engine_count = (int)(sizeof(names) / sizeof(names[0]));
+    long long cells = (long long)workload->rows * workload->cols;
+    EngineConfig config;
+    int inconsistent = 0;
+
+    if (parallel_min_cells_per_thread < 0) {
+        parallel_min_cells_per_thread = 0;
+    }
+
+    default_engine_config(&config);
+    if (overrides->threads > 0) config.threads = overrides->threads;
+    if (overrides->schedule != 0) config.schedule = overrides->schedule;
+    if (overrides->chunk >= 0) config.chunk = overrides->chunk;
+    if (overrides->tile > 0) config.tile = overrides->tile;
+    if (overrides->prefetch >= 0) config.prefetch = overrides->prefetch;
+
+    printf("Aspect ratio sweep: %lld cells, %d generations, %d threads, %s schedule, tile %d\n",
+           cells, workload->generations, config.threads, schedule_name(config.schedule), config.tile);
+    printf("\nMilliseconds per generation\n");
+    printf("%-14s", "grid");
+    for (int e = 0; e < engine_count; e++) {
+        printf(" %10s", names[e]);
+    }
+    printf("\n");
+
+    for (int a = 0; a < (int)(sizeof(aspects) / sizeof(aspects[0])); a++) {
+        // rows = sqrt(cells / aspect), so cols / rows is roughly the aspect ratio
+        Workload shape = *workload;
+        long long target = cells / aspects[a];
+        long long rows = 1;
+        while ((rows + 1) * (rows + 1) <= target) {
+            rows++;
+        }
+        if (rows < 3 || cells / rows > INT_MAX) {
+            break;
+        }
+        shape.rows = (int)rows;
+        shape.cols = (int)(cells / rows);
+
+        char *initial = alloc_grid(shape.rows, shape.cols);
+        char *reference = alloc_grid(shape.rows, shape.cols);
+        char *work = alloc_grid(shape.rows, shape.cols);
+        char label[32];
+
+        initialize_workload_grid(initial, &shape);
+        memcpy(reference, initial, (size_t)shape.rows * shape.cols);
+        engine_serial(reference, shape.rows, shape.cols, shape.generations, &config);
+
+        snprintf(label, sizeof(label), "%dx%d", shape.rows, shape.cols);
+        printf("%-14s", label);
+        for (int e = 0; e < engine_count; e++) {
+            const Engine *engine = find_engine(names[e]);
+            double time_taken = time_engine(engine, initial, work, shape.rows, shape.cols, shape.generations, &config);
+            bool consistent = memcmp(work, reference, (size_t)shape.rows * shape.cols) == 0;
+
+            printf(" %9.4f%s", time_taken / shape.generations * 1000, consistent ? " " : "!");
+            inconsistent += !consistent;
+        }
+        printf("\n");
+
+        free_grid(work);
+        free_grid(reference);
+        free_grid(initial);
+    }
+
+    if (inconsistent > 0) {
+        printf("WARNING: results marked ! differ from the serial reference\n");
+    }
+    return inconsistent > 0 ? 1 : 0;
+}
+
+// Compare the row-major blocked engine with the Morton-tiled engine on square grids of growing size,
+// reporting time and hardware cache misses per cell and generation
+int sweep_layouts(const Workload *workload, const EngineConfig *overrides) {
+    static const int sizes[] = {256, 512, 1024, 2048, 4096};
+    static const char *names[] = {"blocked", "morton"};
+    EngineConfig config;
+    int inconsistent = 0;
+
+    if (parallel_min_cells_per_thread < 0) {
+        parallel_min_cells_per_thread = 0;
+    }
+
+    default_engine_config(&config);
+    if (overrides->threads > 0) config.threads = overrides->threads;
+    if (overrides->schedule != 0) config.schedule = overrides->schedule;
+    if (overrides->chunk >= 0) config.chunk = overrides->chunk;
+    if (overrides->tile > 0) config.tile = overrides->tile;
+    if (overrides->prefetch >= 0) config.prefetch = overrides->prefetch;
+
+    printf("Layout sweep: row-major (blocked) vs Morton-tiled (morton), %d generations, %d threads, tile %d\n",
+           workload->generations, config.threads, config.tile);
+    printf("\n%-12s %-8s %12s", "grid", "layout", "ms/gen");
+#ifdef __linux__
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        printf(" %16s", perf_events[e].name);
+    }
+#endif
+    printf("\n");
+
+    for (int z = 0; z < (int)(sizeof(sizes) / sizeof(sizes[0])); z++) {
+        Workload shape = *workload;
+        shape.rows = shape.cols = sizes[z];
+        if (sizes[z] % config.tile != 0) {
+            continue;
+        }
+
+        char *initial = alloc_grid(shape.rows, shape.cols);
+        char *reference = NULL;
+        char *work = alloc_grid(shape.rows, shape.cols);
+        char label[32];
+        double cells = (double)shape.rows * shape.cols * shape.generations;
+
+        initialize_workload_grid(initial, &shape);
+        snprintf(label, sizeof(label), "%dx%d", shape.rows, shape.cols);
+
+        for (int e = 0; e < 2; e++) {
+            const Engine *engine = find_engine(names[e]);
+            long long counts[PERF_EVENT_COUNT];
+
+            // Warm-up run, then one measured run inside the counters
+            memcpy(work, initial, (size_t)shape.rows * shape.cols);
+            engine->run(work, shape.rows, shape.cols, 1, &config);
+
+            memcpy(work, initial, (size_t)shape.rows * shape.cols);
+            bool counting = perf_counters_begin();
+            double start_time = omp_get_wtime();
+            engine->run(work, shape.rows, shape.cols, shape.generations, &config);
+            double time_taken = omp_get_wtime() - start_time;
+            perf_counters_end(counts);
+
+            if (reference == NULL) {
+                reference = alloc_grid(shape.rows, shape.cols);
+                memcpy(reference, work, (size_t)shape.rows * shape.cols);
+            } else if (memcmp(work, reference, (size_t)shape.rows * shape.cols) != 0) {
+                inconsistent++;
+            }
+
+            printf("%-12s %-8s %12.4f", e == 0 ? label : "", names[e], time_taken / shape.generations * 1000);
+            for (int c = 0; c < PERF_EVENT_COUNT; c++) {
+                if (counting && counts[c] >= 0) {
+                    printf(" %11.4f/cell", counts[c] / cells);
+                } else {
+                    printf(" %16s", "n/a");
+                }
+            }
+            printf("\n");
+        }
+
+        free_grid(reference);
+        free_grid(work);
+        free_grid(initial);
+
+        // The next size cannot reuse these buffers
+        drain_grid_pool();
+    }
+
+    if (inconsistent > 0) {
+        printf("WARNING: %d Morton results differ from the row-major result\n", inconsistent);
+    }
+    return inconsistent > 0 ? 1 : 0;
+}
+
+// Time BARRIER_ROUNDS episodes of the pool barrier
+static void time_pool_barrier(void *arg, int member, int team) {
+    double start_time = omp_get_wtime();
+
+    for (int round = 0; round < BARRIER_ROUNDS && team > 1; round++) {
+        barrier_wait(&thread_pool.barrier);
+    }
+    if (member == 0) {
+        *(double *)arg = (omp_get_wtime() - start_time) / BARRIER_ROUNDS;
+    }
+}
+
+// Compare the pthreads backend with the OpenMP row engine at every probed thread count:
+// barrier latency of each backend, then time per generation on the workload
+int compare_backends(const Workload *workload, const EngineConfig *overrides) {
+    int rows = workload->rows;
+    int cols = workload->cols;
+    int max_threads = overrides->threads > 0 ? overrides->threads : omp_get_max_threads();
+    const Engine *engines_compared[] = {find_engine("rows"), find_engine("pthreads")};
+    char *initial = alloc_grid(rows, cols);
+    char *reference = alloc_grid(rows, cols);
+    char *work = alloc_grid(rows, cols);
+    EngineConfig config;
+    int inconsistent = 0;
+
+    // Compare the backends themselves, not the small-grid path
+    if (parallel_min_cells_per_thread < 0) {
+        parallel_min_cells_per_thread = 0;
+    }
+
+    initialize_workload_grid(initial, workload);
+    memcpy(reference, initial, (size_t)rows * cols);
+    default_engine_config(&config);
+    engine_serial(reference, rows, cols, workload->generations, &config);
+
+    printf("Backend comparison: %dx%d grid, %d generations, static row bands\n", rows, cols, workload->generations);
+    printf("\n%8s %14s %14s %14s %14s\n", "threads", "omp barrier", "pool barrier", "rows ms/gen", "pthreads ms/gen");
+
+    for (int threads = 1; threads <= max_threads; threads = next_thread_count(threads, max_threads)) {
+        double omp_barrier = 0, pool_barrier = 0;
+        double times[2];
+
+        // OpenMP: explicit barriers in one parallel region, after a warm-up episode
+        #pragma omp parallel num_threads(threads)
+        {
+            #pragma omp barrier
+            double start_time = omp_get_wtime();
+            for (int round = 0; round < BARRIER_ROUNDS; round++) {
+                #pragma omp barrier
+            }
+            #pragma omp master
+            omp_barrier = (omp_get_wtime() - start_time) / BARRIER_ROUNDS;
+        }
+        pool_run(threads, time_pool_barrier, &pool_barrier);
+
+        config.threads = threads;
+        for (int e = 0; e < 2; e++) {
+            times[e] = time_engine(engines_compared[e], initial, work, rows, cols, workload->generations, &config);
+            if (memcmp(work, reference, (size_t)rows * cols) != 0) {
+                inconsistent++;
+            }
+        }
+
+        printf("%8d %11.0f ns %11.0f ns %14.4f %14.4f\n", threads, omp_barrier * 1e9, pool_barrier * 1e9,
+               times[0] / workload->generations * 1000, times[1] / workload->generations * 1000);
+    }
+
+    pool_shutdown();
+    free_grid(work);
+    free_grid(reference);
+    free_grid(initial);
+
+    if (inconsistent > 0) {
+        printf("WARNING: %d runs differ from the serial result\n", inconsistent);
+    }
+    return inconsistent > 0 ? 1 : 0;
+}
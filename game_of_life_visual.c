@@ -5,6 +5,8 @@
 #include <string.h>
 #include <time.h>
 #include <omp.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 // Define ANSI color codes for terminal output
 #define ANSI_COLOR_RED     "\x1b[31m"
@@ -21,21 +23,77 @@
 #define WINDOW_WIDTH (GRID_SIZE * CELL_SIZE)
 #define WINDOW_HEIGHT (GRID_SIZE * CELL_SIZE)
 #define CENTER_SIZE 10
-#define DELAY_MS 50
+#define DELAY_MS 50  // Minimum time between generations, so the simulation stays visible
+#define FINAL_HOLD_MS 3000  // How long the final state stays up unless a key is pressed
+#define FRAME_MS 16  // Render loop period (about 60 FPS)
+#define STEP_BUDGET_MS 8  // Share of a frame the stepper may spend computing a generation
+#define STEP_BAND 8  // Rows computed together by the budgeted stepper
+#define EDIT_QUEUE_SIZE 4096  // Pending cell edits (power of two)
+#define EDIT_TILE 10  // Side of the tiles marked dirty by cell edits
+#define EDIT_TILES ((GRID_SIZE + EDIT_TILE - 1) / EDIT_TILE)
 #define ITERATIONS 100  // Exactly 100 generations as required
+#define CALIBRATION_GENERATIONS 20  // Generations timed per team size when measuring the parallel crossover
+#define MAX_RULE_STATES 16   // Most states a Generations rule (B/S/C notation) may have
+#define DYING_CELL(state) ((char)('a' + (state) - 2))  // Cells of Generations rules in state 2 and up
+
+// Progress of a generation computed by the budgeted stepper. Rows are computed into next_grid
+// band by band, possibly over several frames, and grid only changes once all of them are done.
+typedef struct {
+    bool in_progress;
+    int next_row;         // First row of the generation not computed yet
+    double row_cost;      // Measured seconds per row (0 until the first band has run)
+    double compute_time;  // Seconds spent on the current generation so far
+} StepState;
+
+// Cell edit from the mouse or an external feed
+typedef struct {
+    atomic_size_t sequence;
+    int row;
+    int col;
+    char state;
+} EditSlot;
+
+// Bounded lock-free multi-producer queue (Vyukov) of cell edits. Producers claim a slot by
+// advancing enqueue_position with a compare-and-swap and publish it through the slot's sequence;
+// the simulation thread is the only consumer, so dequeue_position needs no atomics.
+typedef struct {
+    EditSlot slots[EDIT_QUEUE_SIZE];
+    atomic_size_t enqueue_position;
+    size_t dequeue_position;
+} EditQueue;
 
 // Function prototypes
 void initialize_grid(char grid[GRID_SIZE][GRID_SIZE]);
 void initialize_random_grid(char grid[GRID_SIZE][GRID_SIZE], float density);
 void initialize_glider_grid(char grid[GRID_SIZE][GRID_SIZE]);
 int count_neighbors(char grid[GRID_SIZE][GRID_SIZE], int row, int col);
-void update_grid_serial(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE]);
-void update_grid_parallel(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE]);
+void update_rows(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE], int first, int last, int team);
+void update_grid_parallel(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE], int team);
+int calibrate_parallel_team(char grid[GRID_SIZE][GRID_SIZE]);
+bool step_grid_budget(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE], int team, double budget, StepState *step);
 void render_grid(SDL_Renderer *renderer, char grid[GRID_SIZE][GRID_SIZE], int live_count);
 int count_live_cells(char grid[GRID_SIZE][GRID_SIZE]);
 void print_simulation_info(int generation, int live_count, double elapsed_time, bool is_parallel);
 void print_help_menu();
 void draw_stats_overlay(SDL_Renderer *renderer, int generation, int live_count, double elapsed_time, bool is_parallel);
+bool parse_rule(const char *text);
+void edit_queue_init(EditQueue *queue);
+bool edit_queue_push(EditQueue *queue, int row, int col, char state);
+bool edit_queue_pop(EditQueue *queue, int *row, int *col, char *state);
+int apply_cell_edits(EditQueue *queue, char grid[GRID_SIZE][GRID_SIZE], bool dirty[EDIT_TILES][EDIT_TILES], int *live_count);
+int feed_cell_edits(void *path);
+char next_cell_state(char cell, int neighbors);
+
+// Active rule: bit n of birth (survive) is set when a dead (live) cell with n live neighbours is
+// alive in the next generation; Generations rules add dying states up to rule_states - 1
+static unsigned int rule_birth = 1 << 3;
+static unsigned int rule_survive = (1 << 2) | (1 << 3);
+static int rule_states = 2;
+
+// Edits waiting for the next generation boundary; dirty marks the tiles edited since the last one
+static EditQueue edit_queue;
+static bool dirty_tiles[EDIT_TILES][EDIT_TILES];
+static atomic_int dropped_edits;
 
 int main(int argc, char* argv[]) {
     // Parse command line arguments
@@ -44,6 +102,7 @@ int main(int argc, char* argv[]) {
     float random_density = 0.3f;
     bool show_help = false;
     bool show_stats = true;
+    const char *feed_path = NULL;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--parallel") == 0) {
@@ -63,6 +122,13 @@ int main(int argc, char* argv[]) {
             show_help = true;
         } else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--no-stats") == 0) {
             show_stats = false;
+        } else if (strcmp(argv[i], "--feed") == 0 && i + 1 < argc) {
+            feed_path = argv[++i];
+        } else if (strcmp(argv[i], "--rule") == 0 && i + 1 < argc) {
+            if (!parse_rule(argv[++i])) {
+                fprintf(stderr, ANSI_COLOR_RED "Invalid rule '%s' (expected B3/S23 or B2/S/C3 notation)\n" ANSI_COLOR_RESET, argv[i]);
+                return 1;
+            }
         }
     }
     
@@ -86,15 +152,21 @@ int main(int argc, char* argv[]) {
     if (pattern_choice == 1) {
         printf(ANSI_COLOR_YELLOW "Random density: %.2f\n" ANSI_COLOR_RESET, random_density);
     }
+    if (rule_states > 2) {
+        printf(ANSI_COLOR_YELLOW "Generations rule with %d states (dying cells fade from yellow to red)\n" ANSI_COLOR_RESET,
+               rule_states);
+    }
     printf("\n");
     
     // Controls information
     printf(ANSI_COLOR_GREEN "Controls:\n" ANSI_COLOR_RESET);
     printf("  • ESC: Exit simulation\n");
     printf("  • P: Toggle parallel/serial processing\n");
-    printf("  • SPACE: Pause for 3 seconds\n");
+    printf("  • SPACE: Pause/resume\n");
+    printf("  • N or RIGHT: Step one generation (1-9: step that many) while paused\n");
     printf("  • R: Reset grid with random pattern\n");
     printf("  • S: Toggle statistics overlay\n");
+    printf("  • Left/right mouse button: Draw live/dead cells\n");
     printf("\n");
     
     char grid[GRID_SIZE][GRID_SIZE];
@@ -140,6 +212,23 @@ int main(int argc, char* argv[]) {
             break;
     }
     
+    // Measure which team size actually pays off on this grid; small grids may run best single-threaded
+    int parallel_team = calibrate_parallel_team(grid);
+    printf(ANSI_COLOR_YELLOW "Parallel team: %d of %d threads\n" ANSI_COLOR_RESET, parallel_team, omp_get_max_threads());
+    printf("\n");
+    
+    // Cell edits reach the grid through the edit queue, from the mouse and an optional feed thread
+    edit_queue_init(&edit_queue);
+    if (feed_path != NULL) {
+        SDL_Thread *feed = SDL_CreateThread(feed_cell_edits, "cell feed", (void *)feed_path);
+        if (feed == NULL) {
+            fprintf(stderr, ANSI_COLOR_RED "Could not start the cell feed: %s\n" ANSI_COLOR_RESET, SDL_GetError());
+        } else {
+            SDL_DetachThread(feed);
+        }
+    }
+    int edits_applied = 0;
+    
     // Main loop
     bool quit = false;
     SDL_Event e;
@@ -147,7 +236,6 @@ int main(int argc, char* argv[]) {
     
     // For timing
     double start_time = omp_get_wtime();
-    double generation_start_time = start_time;
     double elapsed_time = 0.0;
     
     // Statistics tracking
@@ -158,8 +246,20 @@ int main(int argc, char* argv[]) {
     int serial_generations = 0;
     int parallel_generations = 0;
     
+    // Stepper state; a generation starts at most every DELAY_MS and may span several frames
+    StepState step = {false, 0, 0.0, 0.0};
+    double last_generation_time = start_time;
+    int live_count = count_live_cells(grid);
+    max_live_cells = min_live_cells = live_count;
+    
+    // Paused: rendering and input keep running, generations only start on step requests
+    bool paused = false;
+    int steps_pending = 0;
+    double pause_start_time = 0.0;
+    double paused_time = 0.0;
+    
     while (!quit && generation <= ITERATIONS) { // Run for exactly 100 generations (1-100)
-        generation_start_time = omp_get_wtime();
+        double frame_start_time = omp_get_wtime();
         
         // Handle events
         while (SDL_PollEvent(&e) != 0) {
@@ -176,13 +276,28 @@ int main(int argc, char* argv[]) {
                     printf(ANSI_COLOR_YELLOW "Switched to %s processing\n" ANSI_COLOR_RESET, use_parallel ? "parallel" : "serial");
                 }
                 else if (e.key.keysym.sym == SDLK_SPACE) {
-                    // Pause/resume
-                    printf(ANSI_COLOR_BLUE "Simulation paused for 3 seconds\n" ANSI_COLOR_RESET);
-                    SDL_Delay(3000); // Pause for 3 seconds
+                    // Pause/resume; paused wall time is left out of the run's timing
+                    paused = !paused;
+                    steps_pending = 0;
+                    if (paused) {
+                        pause_start_time = frame_start_time;
+                    } else {
+                        paused_time += frame_start_time - pause_start_time;
+                        last_generation_time = frame_start_time - DELAY_MS / 1000.0;
+                    }
+                    printf(ANSI_COLOR_BLUE "\nSimulation %s\n" ANSI_COLOR_RESET, paused ? "paused (N: step, 1-9: step N, SPACE: resume)" : "resumed");
+                }
+                else if (paused && (e.key.keysym.sym == SDLK_n || e.key.keysym.sym == SDLK_RIGHT)) {
+                    steps_pending++;
+                }
+                else if (paused && e.key.keysym.sym >= SDLK_1 && e.key.keysym.sym <= SDLK_9) {
+                    steps_pending += e.key.keysym.sym - SDLK_0;
                 }
                 else if (e.key.keysym.sym == SDLK_r) {
-                    // Reset with random pattern
+                    // Reset with random pattern, dropping any partly computed generation
                     initialize_random_grid(grid, random_density);
+                    step.in_progress = false;
+                    live_count = count_live_cells(grid);
                     printf(ANSI_COLOR_GREEN "Reset grid with random pattern (density: %.2f)\n" ANSI_COLOR_RESET, random_density);
                 }
                 else if (e.key.keysym.sym == SDLK_s) {
@@ -190,20 +305,72 @@ int main(int argc, char* argv[]) {
                     show_stats = !show_stats;
                 }
             }
+            else if (e.type == SDL_MOUSEBUTTONDOWN || (e.type == SDL_MOUSEMOTION && (e.motion.state & (SDL_BUTTON_LMASK | SDL_BUTTON_RMASK)))) {
+                // Draw with the left button, erase with the right one
+                int x = e.type == SDL_MOUSEMOTION ? e.motion.x : e.button.x;
+                int y = e.type == SDL_MOUSEMOTION ? e.motion.y : e.button.y;
+                bool erase = e.type == SDL_MOUSEMOTION ? !(e.motion.state & SDL_BUTTON_LMASK) : e.button.button == SDL_BUTTON_RIGHT;
+                if (x >= 0 && y >= 0 && x < WINDOW_WIDTH && y < WINDOW_HEIGHT &&
+                    !edit_queue_push(&edit_queue, y / CELL_SIZE, x / CELL_SIZE, erase ? '.' : '*')) {
+                    atomic_fetch_add(&dropped_edits, 1);
+                }
+            }
         }
         
-        // Clear screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        
-        // Count live cells
-        int live_count = count_live_cells(grid);
+        // Between generations, apply the queued edits
+        if (!step.in_progress) {
+            edits_applied += apply_cell_edits(&edit_queue, grid, dirty_tiles, &live_count);
+            if (live_count > max_live_cells) max_live_cells = live_count;
+            if (live_count < min_live_cells) min_live_cells = live_count;
+        }
         
-        // Update statistics
-        if (live_count > max_live_cells) max_live_cells = live_count;
-        if (live_count < min_live_cells) min_live_cells = live_count;
+        // Advance the generation in progress as far as this frame's budget allows. Requested steps
+        // start right away; otherwise generations follow the DELAY_MS cadence unless paused.
+        bool start_step = paused && steps_pending > 0;
+        if (step.in_progress || start_step || (!paused && frame_start_time - last_generation_time >= DELAY_MS / 1000.0)) {
+            if (start_step && !step.in_progress) {
+                steps_pending--;
+            } else if (!step.in_progress) {
+                // Keep the DELAY_MS cadence on average, without catching up after a stall
+                last_generation_time += DELAY_MS / 1000.0;
+                if (frame_start_time - last_generation_time > DELAY_MS / 1000.0) {
+                    last_generation_time = frame_start_time;
+                }
+            }
+            if (step_grid_budget(grid, next_grid, use_parallel ? parallel_team : 1, STEP_BUDGET_MS / 1000.0, &step)) {
+                elapsed_time = step.compute_time;
+                
+                // Update timing statistics
+                if (use_parallel) {
+                    total_time_parallel += elapsed_time;
+                    parallel_generations++;
+                } else {
+                    total_time_serial += elapsed_time;
+                    serial_generations++;
+                }
+                
+                // Display generation counter and live cell count
+                char title[100];
+                sprintf(title, "Conway's Game of Life - Gen: %d/%d - Live Cells: %d - %s%s", 
+                        generation, ITERATIONS, live_count, use_parallel ? "Parallel" : "Serial", paused ? " - Paused" : "");
+                SDL_SetWindowTitle(window, title);
+                
+                // Print generation information to terminal
+                print_simulation_info(generation, live_count, elapsed_time, use_parallel);
+                
+                generation++;
+                live_count = count_live_cells(grid);
+                memset(dirty_tiles, 0, sizeof(dirty_tiles));
+                
+                // Update statistics
+                if (live_count > max_live_cells) max_live_cells = live_count;
+                if (live_count < min_live_cells) min_live_cells = live_count;
+            }
+        }
         
-        // Render grid
+        // Render the last completed generation every frame
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
         render_grid(renderer, grid, live_count);
         
         // Draw statistics overlay if enabled
@@ -211,47 +378,31 @@ int main(int argc, char* argv[]) {
             draw_stats_overlay(renderer, generation, live_count, elapsed_time, use_parallel);
         }
         
-        // Update screen
-        SDL_RenderPresent(renderer);
-        
-        // Update grid for next generation
-        if (use_parallel) {
-            update_grid_parallel(grid, next_grid);
-            parallel_generations++;
-        } else {
-            update_grid_serial(grid, next_grid);
-            serial_generations++;
+        // Pause indicator: two bars in the top right corner
+        if (paused) {
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_Rect left_bar = {WINDOW_WIDTH - 40, 10, 10, 30};
+            SDL_Rect right_bar = {WINDOW_WIDTH - 24, 10, 10, 30};
+            SDL_RenderFillRect(renderer, &left_bar);
+            SDL_RenderFillRect(renderer, &right_bar);
         }
         
-        // Calculate elapsed time for this generation
-        double generation_end_time = omp_get_wtime();
-        elapsed_time = generation_end_time - generation_start_time;
+        // Update screen
+        SDL_RenderPresent(renderer);
         
-        // Update timing statistics
-        if (use_parallel) {
-            total_time_parallel += elapsed_time;
-        } else {
-            total_time_serial += elapsed_time;
+        // Sleep for the rest of the frame
+        int frame_ms = (int)((omp_get_wtime() - frame_start_time) * 1000.0);
+        if (frame_ms < FRAME_MS) {
+            SDL_Delay(FRAME_MS - frame_ms);
         }
-        
-        // Display generation counter and live cell count
-        char title[100];
-        sprintf(title, "Conway's Game of Life - Gen: %d/%d - Live Cells: %d - %s", 
-                generation, ITERATIONS, live_count, use_parallel ? "Parallel" : "Serial");
-        SDL_SetWindowTitle(window, title);
-        
-        // Print generation information to terminal
-        print_simulation_info(generation, live_count, elapsed_time, use_parallel);
-        
-        // Delay to make the simulation visible
-        SDL_Delay(DELAY_MS);
-        
-        generation++;
     }
     
     // Calculate and display total execution time
     double end_time = omp_get_wtime();
-    double total_time = end_time - start_time;
+    if (paused) {
+        paused_time += end_time - pause_start_time;
+    }
+    double total_time = end_time - start_time - paused_time;
     
     // Print final statistics
     printf("\n");
@@ -260,7 +411,7 @@ int main(int argc, char* argv[]) {
     printf(ANSI_COLOR_CYAN ANSI_BOLD "╚════════════════════════════════════════════════════════════╝\n" ANSI_COLOR_RESET);
     printf("\n");
     
-    printf(ANSI_COLOR_YELLOW "Total execution time: %.4f seconds\n" ANSI_COLOR_RESET, total_time);
+    printf(ANSI_COLOR_YELLOW "Total execution time: %.4f seconds (excluding %.2f seconds paused)\n" ANSI_COLOR_RESET, total_time, paused_time);
     printf(ANSI_COLOR_YELLOW "Average time per generation: %.4f seconds\n" ANSI_COLOR_RESET, total_time / ITERATIONS);
     printf("\n");
     
@@ -269,6 +420,7 @@ int main(int argc, char* argv[]) {
     printf("  • Minimum live cells: %d\n", min_live_cells);
     printf("  • Serial generations: %d\n", serial_generations);
     printf("  • Parallel generations: %d\n", parallel_generations);
+    printf("  • Cell edits applied: %d (%d dropped with the queue full)\n", edits_applied, atomic_load(&dropped_edits));
     
     if (serial_generations > 0) {
         printf("  • Average serial generation time: %.6f seconds\n", total_time_serial / serial_generations);
@@ -283,10 +435,28 @@ int main(int argc, char* argv[]) {
         printf("  • Parallel speedup: %.2fx\n", speedup);
     }
     
-    // Final pause to see the end result
-    printf("\n");
-    printf(ANSI_COLOR_BLUE "Final state displayed for 3 seconds before exiting...\n" ANSI_COLOR_RESET);
-    SDL_Delay(3000);
+    // Keep the end result on screen, still redrawing and handling input, until a key is pressed,
+    // the window is closed or FINAL_HOLD_MS pass; skipped when the user already quit
+    if (!quit) {
+        printf("\n");
+        printf(ANSI_COLOR_BLUE "Final state displayed for %d seconds (press any key to exit)...\n" ANSI_COLOR_RESET, FINAL_HOLD_MS / 1000);
+        double hold_end_time = omp_get_wtime() + FINAL_HOLD_MS / 1000.0;
+        while (!quit && omp_get_wtime() < hold_end_time) {
+            while (SDL_PollEvent(&e) != 0) {
+                if (e.type == SDL_QUIT || e.type == SDL_KEYDOWN) {
+                    quit = true;
+                }
+            }
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+            render_grid(renderer, grid, live_count);
+            if (show_stats) {
+                draw_stats_overlay(renderer, generation - 1, live_count, elapsed_time, use_parallel);
+            }
+            SDL_RenderPresent(renderer);
+            SDL_Delay(FRAME_MS);
+        }
+    }
     
     // Clean up
     SDL_DestroyRenderer(renderer);
@@ -309,14 +479,19 @@ void print_help_menu() {
     printf("  -r, --random [DENS]  Initialize with random pattern (optional density 0.0-1.0)\n");
     printf("  -g, --glider         Initialize with glider pattern\n");
     printf("  -n, --no-stats       Disable statistics overlay\n");
+    printf("      --rule RULE      Life-like (B3/S23) or Generations (B2/S/C3) rule\n");
+    printf("      --feed FILE      Apply cell edits read from FILE ('-' for stdin): ROW COL [0|1] per line\n");
     printf("  -h, --help           Display this help message\n");
     printf("\n");
     printf(ANSI_COLOR_GREEN "Controls:\n" ANSI_COLOR_RESET);
     printf("  ESC                  Exit simulation\n");
     printf("  P                    Toggle parallel/serial processing\n");
-    printf("  SPACE                Pause for 3 seconds\n");
+    printf("  SPACE                Pause/resume\n");
+    printf("  N, RIGHT             Step one generation while paused\n");
+    printf("  1-9                  Step that many generations while paused\n");
     printf("  R                    Reset grid with random pattern\n");
     printf("  S                    Toggle statistics overlay\n");
+    printf("  Mouse left/right     Draw live/dead cells\n");
 }
 
 // Print simulation information to terminal
@@ -479,77 +654,79 @@ int count_neighbors(char grid[GRID_SIZE][GRID_SIZE], int row, int col) {
     return count;
 }
 
-// Update the grid for the next generation - serial version
-void update_grid_serial(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE]) {
-    // Calculate next generation
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            int neighbors = count_neighbors(grid, i, j);
-            
-            // Apply the rules of the Game of Life
-            if (grid[i][j] == '*') {
-                // Cell is alive
-                if (neighbors < 2 || neighbors > 3) {
-                    // Dies from underpopulation or overpopulation
-                    next_grid[i][j] = '.';
-                } else {
-                    // Survives
-                    next_grid[i][j] = '*';
-                }
-            } else {
-                // Cell is dead
-                if (neighbors == 3) {
-                    // Reproduction
-                    next_grid[i][j] = '*';
-                } else {
-                    // Stays dead
-                    next_grid[i][j] = '.';
-                }
+// Parse a rule in B/S or B/S/C notation into the active rule
+bool parse_rule(const char *text) {
+    unsigned int birth = 0, survive = 0;
+    unsigned int *target = NULL;
+    int states = 2;
+    bool seen_birth = false, seen_survive = false;
+    
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == 'B' || *c == 'b') {
+            target = &birth;
+            seen_birth = true;
+        } else if (*c == 'S' || *c == 's') {
+            target = &survive;
+            seen_survive = true;
+        } else if (*c == 'C' || *c == 'c') {
+            char *end;
+            states = (int)strtol(c + 1, &end, 10);
+            if (end == c + 1 || states < 2 || states > MAX_RULE_STATES) {
+                return false;
             }
+            target = NULL;
+            c = end - 1;
+        } else if (*c >= '0' && *c <= '8' && target != NULL) {
+            *target |= 1u << (*c - '0');
+        } else if (*c != '/') {
+            return false;
         }
     }
     
-    // Copy next_grid back to grid for the next iteration
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            grid[i][j] = next_grid[i][j];
-        }
+    if (!seen_birth || !seen_survive) {
+        return false;
     }
+    rule_birth = birth;
+    rule_survive = survive;
+    rule_states = states;
+    return true;
 }
 
-// Update the grid for the next generation - parallel version with guided scheduling
-void update_grid_parallel(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE]) {
-    // Calculate next generation in parallel
-    #pragma omp parallel for schedule(guided, 1)
-    for (int i = 0; i < GRID_SIZE; i++) {
+// Next state of a cell under the active rule; only live ('*') cells count as neighbours, and
+// cells that do not survive pass through the dying states of Generations rules
+char next_cell_state(char cell, int neighbors) {
+    if (cell == '.') {
+        return ((rule_birth >> neighbors) & 1) ? '*' : '.';
+    }
+    if (cell == '*' && ((rule_survive >> neighbors) & 1)) {
+        return '*';
+    }
+    
+    int state = cell == '*' ? 1 : cell - 'a' + 2;
+    return state + 1 < rule_states ? DYING_CELL(state + 1) : '.';
+}
+
+// Compute rows [first, last) of the next generation into next_grid with a team of threads
+// (a team of 1 skips the OpenMP fork entirely)
+void update_rows(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE], int first, int last, int team) {
+    #pragma omp parallel for schedule(guided, 1) num_threads(team) if(team > 1)
+    for (int i = first; i < last; i++) {
         for (int j = 0; j < GRID_SIZE; j++) {
             int neighbors = count_neighbors(grid, i, j);
             
-            // Apply the rules of the Game of Life
-            if (grid[i][j] == '*') {
-                // Cell is alive
-                if (neighbors < 2 || neighbors > 3) {
-                    // Dies from underpopulation or overpopulation
-                    next_grid[i][j] = '.';
-                } else {
-                    // Survives
-                    next_grid[i][j] = '*';
-                }
-            } else {
-                // Cell is dead
-                if (neighbors == 3) {
-                    // Reproduction
-                    next_grid[i][j] = '*';
-                } else {
-                    // Stays dead
-                    next_grid[i][j] = '.';
-                }
-            }
+            // Apply the active rule (B3/S23 unless --rule says otherwise)
+            next_grid[i][j] = next_cell_state(grid[i][j], neighbors);
         }
     }
+}
+
+// Update the grid for the next generation - parallel version with guided scheduling
+void update_grid_parallel(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE], int team) {
+    // Calculate next generation in parallel
+    update_rows(grid, next_grid, 0, GRID_SIZE, team);
     
     // Copy next_grid back to grid for the next iteration - also parallelized
-    #pragma omp parallel for schedule(guided, 1)
+    #pragma omp parallel for schedule(guided, 1) num_threads(team) if(team > 1)
     for (int i = 0; i < GRID_SIZE; i++) {
         for (int j = 0; j < GRID_SIZE; j++) {
             grid[i][j] = next_grid[i][j];
@@ -557,6 +734,173 @@ void update_grid_parallel(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_S
     }
 }
 
+// Find the fastest team size for the parallel update on this host by timing each candidate
+// on a copy of the grid. Returns 1 when the grid is too small for parallelism to help.
+int calibrate_parallel_team(char grid[GRID_SIZE][GRID_SIZE]) {
+    char work[GRID_SIZE][GRID_SIZE];
+    char next_grid[GRID_SIZE][GRID_SIZE];
+    int max_threads = omp_get_max_threads();
+    int best_team = 1;
+    double best_time = 0;
+    
+    for (int team = 1; team <= max_threads; team = (team * 2 > max_threads && team < max_threads) ? max_threads : team * 2) {
+        memcpy(work, grid, sizeof(work));
+        update_grid_parallel(work, next_grid, team); // Warm up the thread team
+        
+        double start_time = omp_get_wtime();
+        for (int i = 0; i < CALIBRATION_GENERATIONS; i++) {
+            update_grid_parallel(work, next_grid, team);
+        }
+        double time_taken = omp_get_wtime() - start_time;
+        
+        if (team == 1 || time_taken < best_time) {
+            best_time = time_taken;
+            best_team = team;
+        }
+    }
+    
+    return best_team;
+}
+
+// Advance the grid by one generation within a time budget. Rows are computed in bands of
+// STEP_BAND; each batch holds as many bands as the measured cost per row fits in the remaining
+// budget, and at least one band runs per call so the generation always makes progress. Returns
+// true, with grid holding the new generation, once the last band is done; until then grid still
+// holds the previous, complete generation.
+bool step_grid_budget(char grid[GRID_SIZE][GRID_SIZE], char next_grid[GRID_SIZE][GRID_SIZE], int team, double budget, StepState *step) {
+    double deadline = omp_get_wtime() + budget;
+    
+    if (!step->in_progress) {
+        step->in_progress = true;
+        step->next_row = 0;
+        step->compute_time = 0.0;
+    }
+    
+    do {
+        double start_time = omp_get_wtime();
+        int rows = step->row_cost > 0 ? (int)((deadline - start_time) / step->row_cost) : STEP_BAND;
+        rows = rows < STEP_BAND ? STEP_BAND : rows / STEP_BAND * STEP_BAND;
+        if (rows > GRID_SIZE - step->next_row) {
+            rows = GRID_SIZE - step->next_row;
+        }
+        int first_row = step->next_row;
+        
+        update_rows(grid, next_grid, first_row, first_row + rows, team);
+        
+        double elapsed = omp_get_wtime() - start_time;
+        step->row_cost = elapsed / rows;
+        step->compute_time += elapsed;
+        step->next_row += rows;
+    } while (step->next_row < GRID_SIZE && omp_get_wtime() < deadline);
+    
+    if (step->next_row < GRID_SIZE) {
+        return false;
+    }
+    memcpy(grid, next_grid, sizeof(char) * GRID_SIZE * GRID_SIZE);
+    step->in_progress = false;
+    return true;
+}
+
+// Empty the edit queue: every slot starts out free for the enqueue of its own index
+void edit_queue_init(EditQueue *queue) {
+    for (size_t i = 0; i < EDIT_QUEUE_SIZE; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+    }
+    atomic_init(&queue->enqueue_position, 0);
+    queue->dequeue_position = 0;
+}
+
+// Queue a cell edit from any thread without locking; false when the queue is full
+bool edit_queue_push(EditQueue *queue, int row, int col, char state) {
+    size_t position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+    EditSlot *slot;
+    
+    for (;;) {
+        slot = &queue->slots[position & (EDIT_QUEUE_SIZE - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        
+        if (difference == 0) {
+            // The slot is free for this position; claim it unless another producer did first
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+        }
+    }
+    
+    slot->row = row;
+    slot->col = col;
+    slot->state = state;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return true;
+}
+
+// Take the oldest cell edit; only the simulation thread calls this
+bool edit_queue_pop(EditQueue *queue, int *row, int *col, char *state) {
+    EditSlot *slot = &queue->slots[queue->dequeue_position & (EDIT_QUEUE_SIZE - 1)];
+    size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    
+    if (sequence != queue->dequeue_position + 1) {
+        return false;
+    }
+    *row = slot->row;
+    *col = slot->col;
+    *state = slot->state;
+    atomic_store_explicit(&slot->sequence, queue->dequeue_position + EDIT_QUEUE_SIZE, memory_order_release);
+    queue->dequeue_position++;
+    return true;
+}
+
+// Apply the queued edits at a generation boundary, keeping the live count current and marking only
+// the tiles that changed dirty. At most one queue's worth is applied, so a busy feed cannot stall
+// the frame. Returns the number of cells changed.
+int apply_cell_edits(EditQueue *queue, char grid[GRID_SIZE][GRID_SIZE], bool dirty[EDIT_TILES][EDIT_TILES], int *live_count) {
+    int row, col;
+    char state;
+    int changed = 0;
+    
+    for (int i = 0; i < EDIT_QUEUE_SIZE && edit_queue_pop(queue, &row, &col, &state); i++) {
+        if (row < 0 || col < 0 || row >= GRID_SIZE || col >= GRID_SIZE || grid[row][col] == state) {
+            continue;
+        }
+        *live_count += (state == '*') - (grid[row][col] == '*');
+        grid[row][col] = state;
+        dirty[row / EDIT_TILE][col / EDIT_TILE] = true;
+        changed++;
+    }
+    return changed;
+}
+
+// Feed thread: reads "ROW COL [STATE]" lines (state 1 or absent: live, 0: dead) from a file or
+// stdin and queues them as cell edits, waiting while the queue is full
+int feed_cell_edits(void *path) {
+    FILE *input = strcmp((const char *)path, "-") == 0 ? stdin : fopen((const char *)path, "r");
+    char line[128];
+    
+    if (input == NULL) {
+        fprintf(stderr, ANSI_COLOR_RED "Could not open cell feed '%s'\n" ANSI_COLOR_RESET, (const char *)path);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), input) != NULL) {
+        int row, col, state = 1;
+        if (line[0] == '#' || sscanf(line, "%d %d %d", &row, &col, &state) < 2) {
+            continue;
+        }
+        while (!edit_queue_push(&edit_queue, row, col, state ? '*' : '.')) {
+            SDL_Delay(1);
+        }
+    }
+    if (input != stdin) {
+        fclose(input);
+    }
+    return 0;
+}
+
 // Count the number of live cells in the grid
 int count_live_cells(char grid[GRID_SIZE][GRID_SIZE]) {
     int count = 0;
@@ -610,6 +954,12 @@ void render_grid(SDL_Renderer *renderer, char grid[GRID_SIZE][GRID_SIZE], int li
                 // Draw a border around live cells for better visibility
                 SDL_SetRenderDrawColor(renderer, 255, 255, 255, 100);
                 SDL_RenderDrawRect(renderer, &cell);
+            } else if (grid[i][j] != '.') {
+                // Dying cell of a Generations rule - fades from yellow to dark red with its state
+                int state = grid[i][j] - 'a' + 2;
+                int fade = 255 * (rule_states - state) / (rule_states - 1);
+                SDL_SetRenderDrawColor(renderer, 80 + fade * 175 / 255, fade * 200 / 255, 0, 255);
+                SDL_RenderFillRect(renderer, &cell);
             } else {
                 // Dead cell - dark gray (to show grid lines)
                 SDL_SetRenderDrawColor(renderer, 20, 20, 20, 255);
@@ -617,4 +967,15 @@ void render_grid(SDL_Renderer *renderer, char grid[GRID_SIZE][GRID_SIZE], int li
             }
         }
     }
+    
+    // Outline the tiles edited since the last generation
+    SDL_SetRenderDrawColor(renderer, 0, 200, 255, 255);
+    for (int i = 0; i < EDIT_TILES; i++) {
+        for (int j = 0; j < EDIT_TILES; j++) {
+            if (dirty_tiles[i][j]) {
+                SDL_Rect tile = {j * EDIT_TILE * CELL_SIZE, i * EDIT_TILE * CELL_SIZE, EDIT_TILE * CELL_SIZE, EDIT_TILE * CELL_SIZE};
+                SDL_RenderDrawRect(renderer, &tile);
+            }
+        }
+    }
 }
\ No newline at end of file